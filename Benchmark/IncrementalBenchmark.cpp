@@ -0,0 +1,72 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+// Reports the latency of editing a large document through the
+// IncrementalParser ("after") against parsing it from scratch ("before"),
+// and checks that both end with the same diagnostics.
+//
+// Usage: IncrementalBenchmark [lines] [edits]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../Parser/IncrementalParser.hpp"
+
+static std::string
+SyntheticSource(std::size_t lines) {
+  std::string source;
+  for (std::size_t i = 0; i * 6 < lines; ++i) {
+    source += std::format("generated_function_{} :: () int {{\n", i);
+    source += "    accumulator_value:int = 1234 + 56 * (another_variable_name - 7);\n";
+    source += "    another_variable_name:int = accumulator_value / 3 + helper_call();\n";
+    source += "    return accumulator_value + another_variable_name;\n";
+    source += "}\n\n";
+  }
+  return source;
+}
+
+using Clock = std::chrono::steady_clock;
+using Micros = std::chrono::duration<double, std::micro>;
+
+int main(int argc, char* argv[]) {
+  const std::size_t lines = argc > 1 ? std::stoul(argv[1]) : 100000;
+  const int edits = argc > 2 ? std::stoi(argv[2]) : 200;
+  const std::string source = SyntheticSource(lines);
+
+  auto start = Clock::now();
+  IncrementalParser document("<benchmark>", source);
+  const Micros full = Clock::now() - start;
+
+  // Types "return 1;" and deletes it again, one character at a time, at the
+  // start of a function body in the middle of the file.
+  const int line = static_cast<int>(lines / 2 / 6 * 6 + 1);
+  const std::string_view typed = "return 1;";
+  std::vector<double> latencies;
+  for (int edit = 0; edit < edits; ++edit) {
+    const int step = edit % (2 * static_cast<int>(typed.size()));
+    start = Clock::now();
+    if (step < static_cast<int>(typed.size())) {
+      document.Edit(line, 4 + step, line, 4 + step, typed.substr(step, 1));
+    } else {
+      const int column = 4 + 2 * static_cast<int>(typed.size()) - step - 1;
+      document.Edit(line, column, line, column + 1, "");
+    }
+    latencies.push_back(Micros(Clock::now() - start).count());
+  }
+  std::ranges::sort(latencies);
+
+  IncrementalParser fresh("<benchmark>", document.Text());
+  const bool same = fresh.Diagnostics().size() == document.Diagnostics().size() && fresh.Text() == document.Text();
+
+  std::cout << std::format("\n{} lines, {} chunks\n", lines, document.getChunkCount());
+  std::cout << std::format("before (full parse): {:.0f} us\n", full.count());
+  std::cout << std::format("after  (per edit):   median {:.1f} us, p99 {:.1f} us, max {:.1f} us\n",
+    latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back());
+  if (!same) {
+    std::cerr << "Incremental result differs from a full parse" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,198 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+// Reports lexer throughput for the original lexer, which read a stream and
+// classified one byte at a time with std::isspace/std::isalnum ("before"),
+// and for the current lexer with each scanner level the host supports.
+// Lexing includes interning every identifier, so the scanning loops alone
+// are timed too, which is where the scanner levels differ.
+//
+// Usage: LexerBenchmark [file.cej] [repetitions]
+// Without a file, a synthetic source of generated functions is lexed.
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Lexer/Lexer.cpp"
+
+static std::string
+SyntheticSource(std::size_t functions) {
+  std::string source;
+  for (std::size_t i = 0; i < functions; ++i) {
+    source += std::format("generated_function_{} :: () int {{\n", i);
+    source += "    accumulator_value:int = 1234 + 56 * (another_variable_name - 7);\n";
+    source += "    another_variable_name = accumulator_value / 3 + helper_call();\n";
+    source += "        \n";
+    source += "    return accumulator_value + another_variable_name;\n";
+    source += "}\n\n";
+  }
+  return source;
+}
+
+static const char*
+LevelName(Scanner::Level level) {
+  switch (level) {
+    case Scanner::Level::Scalar: return "scalar";
+    case Scanner::Level::SSE2: return "sse2";
+    case Scanner::Level::AVX2: return "avx2";
+    case Scanner::Level::NEON: return "neon";
+  }
+  return "unknown";
+}
+
+// The lexer as it was before the scanner: a stream read with get(), one
+// std::isspace/std::isdigit/std::isalnum test per byte and a std::string
+// per token. Counts tokens the same way Lexer does.
+static std::size_t
+BaselineTokens(std::istream& input) {
+  std::size_t tokens = 0;
+  int lineCount = 0;
+  int positionCount = 0;
+  char ch;
+  while (input.get(ch)) {
+    if (positionCount == 0) {
+      lineCount++;
+    }
+    positionCount++;
+    if ('\n' == ch) {
+      positionCount = 0;
+      continue;
+    }
+    if (std::isspace(ch)) {
+      continue;
+    }
+    std::string value(1, ch);
+    if (std::isdigit(ch)) {
+      while (input.get(ch) && (std::isdigit(ch) || std::isspace(ch))) {
+        if (!std::isspace(ch)) {
+          value += ch;
+        }
+      }
+      if (input) {
+        input.putback(ch);
+      }
+    } else if (std::isalpha(ch)) {
+      while (input.get(ch) && (std::isalnum(ch) || ch == '_')) {
+        value += ch;
+      }
+      if (input) {
+        input.putback(ch);
+      }
+    } else if (ch == ':' && input.get(ch)) {
+      if (ch == ':' || ch == '=') {
+        value += ch;
+      } else {
+        input.putback(ch);
+      }
+    }
+    tokens++;
+  }
+  return tokens;
+}
+
+// The lexer's scanning loop without interning or building tokens.
+static std::size_t
+ScannedRuns(std::string_view source) {
+  const char* cursor = source.data();
+  const char* end = cursor + source.size();
+  const char* lineStart = cursor;
+  int lineCount = 1;
+  std::size_t runs = 0;
+  while (true) {
+    cursor = Scanner::skipWhitespace(cursor, end, lineCount, lineStart);
+    if (cursor == end) {
+      return runs;
+    }
+    if (Scanner::isDigit(*cursor)) {
+      cursor = Scanner::skipDigits(cursor, end);
+    } else if (Scanner::isAlpha(*cursor)) {
+      cursor = Scanner::skipIdentifier(cursor + 1, end);
+    } else {
+      ++cursor;
+    }
+    runs++;
+  }
+}
+
+// Returns the best observed throughput of run over source in MB/s.
+static double
+Measure(std::string_view source, int repetitions, const std::function<std::size_t()>& run, std::size_t& count) {
+  double best = 0;
+  for (int rep = 0; rep < repetitions; ++rep) {
+    const auto start = std::chrono::steady_clock::now();
+    count = run();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::max(best, static_cast<double>(source.size()) / 1e6 / elapsed.count());
+  }
+  return best;
+}
+
+int main(int argc, char* argv[]) {
+  std::string source;
+  if (argc > 1) {
+    std::ifstream file(argv[1]);
+    if (!file.is_open()) {
+      std::cerr << "Failed to open " << argv[1] << std::endl;
+      return 1;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    source = contents.str();
+  } else {
+    source = SyntheticSource(200000);
+  }
+  const int repetitions = argc > 2 ? std::stoi(argv[2]) : 5;
+  const Scanner::Level defaultLevel = Scanner::level();
+
+  std::size_t tokens = 0;
+  const double before = Measure(source, repetitions, [&] {
+    std::istringstream input(source);
+    return BaselineTokens(input);
+  }, tokens);
+  std::cout << std::format("\n{:.1f} MB, {} tokens, default scanner {}\n", static_cast<double>(source.size()) / 1e6,
+                           tokens, LevelName(defaultLevel));
+  std::cout << std::format("before (per byte): {:.1f} MB/s\n", before);
+
+  std::vector<Scanner::Level> levels = {Scanner::Level::Scalar};
+  for (const Scanner::Level level : {Scanner::Level::SSE2, Scanner::Level::AVX2, Scanner::Level::NEON}) {
+    Scanner::setLevel(level);
+    if (Scanner::level() == level) {
+      levels.push_back(level);
+    }
+  }
+  bool mismatch = false;
+  double scalarLex = 0;
+  double scalarScan = 0;
+  for (const Scanner::Level level : levels) {
+    Scanner::setLevel(level);
+    std::size_t lexed = 0;
+    const double lex = Measure(source, repetitions, [&] {
+      Lexer lexer(source, "<benchmark>");
+      std::size_t count = 0;
+      while (lexer.getNextToken().kind != TokenKind::TK_EOF) {
+        count++;
+      }
+      return count;
+    }, lexed);
+    std::size_t runs = 0;
+    const double scan = Measure(source, repetitions, [&] { return ScannedRuns(source); }, runs);
+    if (level == Scanner::Level::Scalar) {
+      scalarLex = lex;
+      scalarScan = scan;
+    }
+    std::cout << std::format("after  ({}): lex {:.1f} MB/s ({:.2f}x before, {:.2f}x scalar), "
+                             "scan only {:.1f} MB/s ({:.2f}x scalar)\n",
+                             LevelName(level), lex, lex / before, lex / scalarLex, scan, scan / scalarScan);
+    mismatch |= lexed != tokens;
+  }
+  if (mismatch) {
+    std::cerr << "Token count mismatch between lexers" << std::endl;
+    return 1;
+  }
+  return 0;
+}
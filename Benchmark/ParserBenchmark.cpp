@@ -0,0 +1,95 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+// Reports parser throughput against thread count and checks that every
+// thread count produces the same assembly.
+//
+// Usage: ParserBenchmark [file.cej] [repetitions] [max threads]
+// Without a file, a synthetic unit of generated functions is parsed.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../Generator/Generator.cpp"
+
+static std::string
+SyntheticSource(std::size_t functions) {
+  std::string source;
+  for (std::size_t i = 0; i < functions; ++i) {
+    source += std::format("generated_function_{} :: () int {{\n", i);
+    source += "    accumulator_value:int = 1234 + 56 * (98765 - 7);\n";
+    source += "    another_variable_name:int = accumulator_value / 3 + helper_call(1, 2 * accumulator_value);\n";
+    source += "    accumulator_value = -(accumulator_value - another_variable_name) * (3 + 4 * 5);\n";
+    source += "    return accumulator_value + another_variable_name;\n";
+    source += "}\n\n";
+  }
+  return source;
+}
+
+struct Result {
+  double seconds;
+  std::string assembly;
+};
+
+// Parse time only: tokenizing happens in the Parser constructor, outside the
+// timed region. Returns the best of `repetitions`.
+static Result
+Measure(std::string_view source, int repetitions, unsigned threads) {
+  Result result{1e300, {}};
+  for (int rep = 0; rep < repetitions; ++rep) {
+    Lexer lexer(source, "<benchmark>");
+    Parser parser(lexer);
+    parser.setThreadCount(threads);
+    const auto start = std::chrono::steady_clock::now();
+    auto tree = parser.parseUnit();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = std::min(result.seconds, elapsed.count());
+    if (rep == 0) {
+      result.assembly = Generator::GenerateAssembly(*tree);
+    }
+  }
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  std::string source;
+  if (argc > 1) {
+    std::ifstream file(argv[1]);
+    if (!file.is_open()) {
+      std::cerr << "Failed to open " << argv[1] << std::endl;
+      return 1;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    source = contents.str();
+  } else {
+    source = SyntheticSource(50000);
+  }
+  const int repetitions = argc > 2 ? std::stoi(argv[2]) : 3;
+  const unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoi(argv[3])) : DefaultThreadCount();
+
+  std::vector<std::pair<unsigned, Result>> results;
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+    results.emplace_back(threads, Measure(source, repetitions, threads));
+  }
+  if (results.back().first != maxThreads) {
+    results.emplace_back(maxThreads, Measure(source, repetitions, maxThreads));
+  }
+
+  const double megabytes = static_cast<double>(source.size()) / 1e6;
+  const double baseline = results.front().second.seconds;
+  std::cout << std::format("\n{:.1f} MB\n", megabytes);
+  for (const auto& [threads, result] : results) {
+    std::cout << std::format("{:>3} threads: {:8.1f} MB/s ({:.2f}x)\n", threads, megabytes / result.seconds, baseline / result.seconds);
+  }
+  for (const auto& [threads, result] : results) {
+    if (result.assembly != results.front().second.assembly) {
+      std::cerr << "Output with " << threads << " threads differs from single threaded output" << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -160,14 +160,17 @@ BuildSystem::ParseBuildFile(const std::string& filename) {
 
 void
 BuildSystem::BuildAll() const {
-    for (auto& target : targets) {
-      target->GenerateAssembly(buildDir);
+    // Libraries first, so their module interfaces exist when executables import them.
+    std::vector<std::shared_ptr<BuildTarget>> ordered = targets;
+    std::ranges::stable_partition(ordered, [](const auto& target) { return dynamic_cast<Library*>(target.get()) != nullptr; });
+    for (auto& target : ordered) {
+      const CompilerOptions targetOptions = target->Options(options);
+      target->Compile(buildDir, targetOptions);
       if (windowsOS) {
           std::cout << "Skipping assembler / linker - Only supporting arm architecture currently" << std::endl;
           return;
       }
-      target->Assemble(buildDir);
-      target->Link(buildDir);
+      target->Link(buildDir, targetOptions);
     }
 }
 
@@ -178,10 +181,18 @@ void BuildSystem::GenerateMakefile(const std::string& filename) {
 
     // Write variables
     makefile << "CC = your_compiler\n";
-    makefile << "AS = as\n";
-    makefile << "LD = ld\n";
-    makefile << "CFLAGS = \n";
-    makefile << "LDFLAGS = -lSystem -syslibroot `xcrun -sdk macosx --show-sdk-path`\n\n";
+    // Tools for the command line's target, cross tools if it is not the host's.
+    makefile << "AS = " << options.Tool("as") << "\n";
+    makefile << "LD = " << options.Tool("ld") << "\n";
+    makefile << "AR = " << options.Tool("ar") << "\n";
+    // Flags from the command line come after each target's compiler_flags,
+    // so they win, as they do when the compiler builds the targets itself.
+    makefile << "CFLAGS =";
+    for (const auto& flag : options.flags) {
+        makefile << " " << flag;
+    }
+    makefile << "\n";
+    makefile << "LDFLAGS =\n\n";
 
     // Write the 'all' target
     makefile << "all:";
@@ -207,7 +218,7 @@ void BuildSystem::GenerateMakefile(const std::string& filename) {
 
     // Add a clean target
     makefile << "clean:\n\t";
-    makefile << "rm -f *.o *.s";
+    makefile << "rm -f *.o *.s *.cejm *.ir";
     for (const auto& target : targets) {
         if (dynamic_cast<Library*>(target.get())) {
             makefile << " " << target->output_dir << "/lib" << target->name << ".a";
@@ -242,7 +253,7 @@ BuildSystem::GenerateMakefileForLibrary(std::ofstream& makefile, Library* lib) {
         if (!lib->compiler_flags.empty()) {
             makefile << " " << lib->compiler_flags;
         }
-        makefile << "\n\n";
+        makefile << " $(CFLAGS)\n\n";
 
         // Rule to assemble (.s to .o)
         makefile << objectFile << ": " << assemblyFile << "\n\t";
@@ -264,7 +275,7 @@ BuildSystem::GenerateMakefileForLibrary(std::ofstream& makefile, Library* lib) {
             }
         }
     }
-    makefile << "\n\tar rcs " << libFile;
+    makefile << "\n\t$(AR) rcs " << libFile;
     for (const auto& obj : objectFiles) {
         makefile << " " << obj;
     }
@@ -293,7 +304,7 @@ BuildSystem::GenerateMakefileForExecutable(std::ofstream& makefile, Executable*
         if (!exe->compiler_flags.empty()) {
             makefile << " " << exe->compiler_flags;
         }
-        makefile << "\n\n";
+        makefile << " $(CFLAGS)\n\n";
 
         // Rule to assemble (.s to .o)
         makefile << objectFile << ": " << assemblyFile << "\n\t";
@@ -327,9 +338,6 @@ BuildSystem::GenerateMakefileForExecutable(std::ofstream& makefile, Executable*
     for (const auto& lib : exe->libs) {
         makefile << " -l" << lib;
     }
-    if (!exe->compiler_flags.empty()) {
-        makefile << " " << exe->compiler_flags;
-    }
     makefile << " $(LDFLAGS)\n\n";
 }
 
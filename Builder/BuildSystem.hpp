@@ -21,6 +21,7 @@ class BuildSystem {
     std::vector<std::shared_ptr<BuildTarget>> targets;
     std::filesystem::path sourceDir;
     std::filesystem::path buildDir;
+    CompilerOptions options;
     void GenerateMakefile(const std::string& filename);
     static std::vector<std::string> split(const std::string &s, char delimiter);
     void ParseBuildFile(const std::string &filename);
@@ -2,34 +2,82 @@
 // Created by Elijah Crain on 10/27/24.
 //
 
+#include <iostream>
+#include <sstream>
 #include "BuildTarget.hpp"
 #include "../Lexer/Lexer.cpp"
 #include "../Parser/Parser.cpp"
 #include "../Generator/Generator.cpp"
+#include "../Module/ImportResolver.hpp"
+
+// The target's compiler_flags, then the command line's flags, so a build can
+// be switched to, say, -O0 without editing the build file.
+CompilerOptions BuildTarget::Options(const CompilerOptions& commandLine) const {
+  CompilerOptions options;
+  std::istringstream flags(compiler_flags);
+  for (std::string flag; flags >> flag;) {
+    try {
+      if (!options.Parse(flag)) {
+        std::cerr << "Warning: Unknown compiler flag '" << flag << "' for target " << name << std::endl;
+      }
+    } catch (const std::runtime_error& error) {
+      std::cerr << "Warning: " << error.what() << " for target " << name << std::endl;
+    }
+  }
+  for (const std::string& flag : commandLine.flags) {
+    options.Parse(flag);
+  }
+  return options;
+}
+
+void BuildTarget::Compile(const std::filesystem::path& buildDir, const CompilerOptions& options) {
+  // Interfaces of earlier sources and targets are written to buildDir, so it
+  // is searched before the configured include_dirs.
+  std::vector<std::filesystem::path> searchDirs = {buildDir};
+  searchDirs.insert(searchDirs.end(), include_dirs.begin(), include_dirs.end());
+  ImportResolver resolver(searchDirs);
 
-void BuildTarget::GenerateAssembly(const std::filesystem::path& buildDir) {
   for (const auto& source : sources) {
     Lexer lexer(source);
     Parser parser(lexer);
     auto tree = parser.parseUnit();
-    std::string outData = Generator::GenerateAssembly(tree);
+    if (options.reportArena) {
+      parser.reportArena(*tree, std::cout);
+    }
+    resolver.Resolve(*tree);
+    IRModule module = Generator::BuildIR(*tree, options);
 
     // Generate output filename
     size_t front = source.find_first_of('/')== std::string::npos ? 0 : source.find_last_of('/') + 1;
-    std::string assemblyFile = source.substr(front, source.find_last_of('.')-front) + ".s";
-    std::ofstream outFile(buildDir / assemblyFile);
-    outFile.write(outData.data(), outData.size());
-    outFile.close();
+    std::string stem = source.substr(front, source.find_last_of('.')-front);
+    if (options.emitIR) {
+      std::ofstream irFile(buildDir / (stem + ".ir"));
+      irFile << IRPrinter::Print(module);
+    }
+    // The object goes where the linkers look for it, beside the source's
+    // path under buildDir.
+    const std::filesystem::path objectFile = buildDir / (source.substr(0, source.find_last_of('.')) + ".o");
+    std::filesystem::create_directories(objectFile.parent_path());
+    if (options.target != Target::AArch64) {
+      // Only AArch64 is assembled in process; other targets go through the
+      // assembler for the target.
+      const std::filesystem::path assemblyFile = buildDir / (stem + ".s");
+      std::ofstream(assemblyFile) << Generator::GenerateAssembly(module, options);
+      const std::string command = options.Tool("as") + " -o " + objectFile.string() + " " + assemblyFile.string();
+      if (system(command.c_str()) != 0) {
+        throw std::runtime_error("Assembling " + assemblyFile.string() + " failed");
+      }
+    } else {
+      std::string assembly;
+      const std::vector<std::uint8_t> object = Generator::GenerateObject(module, options, options.emitAssembly ? &assembly : nullptr);
+      if (options.emitAssembly) {
+        std::ofstream assemblyFile(buildDir / (stem + ".s"));
+        assemblyFile << assembly;
+      }
+      std::ofstream outFile(objectFile, std::ios::binary);
+      outFile.write(reinterpret_cast<const char*>(object.data()), static_cast<std::streamsize>(object.size()));
+      outFile.close();
+    }
+    ModuleInterface::Write(buildDir / (stem + std::string(ModuleInterface::Extension)), *tree);
   }
 }
-
-void BuildTarget::Assemble(const std::filesystem::path& buildDir) {
-  for (const auto& source : sources) {
-    std::filesystem::path assemblyFile = buildDir / std::string(source.substr(0, source.find_last_of('.')) + ".s");
-    std::filesystem::path objectFile = buildDir / std::string(source.substr(0, source.find_last_of('.')) + ".o");
-
-    std::string command = "as -o " + objectFile.string() + " " + assemblyFile.string();
-    system(command.c_str());
-  }
-}
-
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <filesystem>
+#include "../Generator/CompilerOptions.hpp"
 
 class BuildTarget {
   public:
@@ -19,9 +20,13 @@ class BuildTarget {
   std::string output_dir;
   std::string compiler_flags;
 
-  virtual void GenerateAssembly(const std::filesystem::path& buildDir);
-  virtual void Assemble(const std::filesystem::path& buildDir);
-  virtual void Link(const std::filesystem::path& buildDir) = 0;
+  // Options for compiling this target's sources.
+  CompilerOptions Options(const CompilerOptions& commandLine) const;
+  // Writes an object file and a module interface for each source, with
+  // the target's options.
+  virtual void Compile(const std::filesystem::path& buildDir, const CompilerOptions& options);
+  // Links the objects with the tools for options.target.
+  virtual void Link(const std::filesystem::path& buildDir, const CompilerOptions& options) = 0;
 };
 
 
@@ -6,16 +6,18 @@
 
 class Executable : public BuildTarget {
   public:
-  void Link(const std::filesystem::path& buildDir) override;
+  void Link(const std::filesystem::path& buildDir, const CompilerOptions& options) override;
 };
 
-void Executable::Link(const std::filesystem::path& buildDir) {
+void Executable::Link(const std::filesystem::path& buildDir, const CompilerOptions& options) {
   const std::filesystem::path execDir = buildDir / output_dir;
   if (!std::filesystem::exists(execDir)) {
     std::filesystem::create_directory(execDir);
   }
   const std::filesystem::path executableFile = execDir / name;
-  std::string command = "ld -o " + executableFile.string();
+  // Programs exit through a system call and need no C runtime, so ld for
+  // the target links the objects as they are.
+  std::string command = options.Tool("ld") + " -o " + executableFile.string();
 
   // Add object files
   for (const auto& source : sources) {
@@ -33,8 +35,5 @@ void Executable::Link(const std::filesystem::path& buildDir) {
     command += " -l" + lib;
   }
 
-  // Add system libraries (from your template command)
-  command += " -lSystem -syslibroot `xcrun -sdk macosx --show-sdk-path`";
-
   system(command.c_str());
 }
@@ -0,0 +1,343 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef ASSEMBLER_HPP
+#define ASSEMBLER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ElfWriter.hpp"
+#include "Peephole.hpp"
+
+// Encodes the AArch64 the Generator emits into machine code, in process.
+// Only the instructions, operand forms and directives the Generator uses are
+// known; anything else is an error rather than a silent misencoding.
+//
+// Runs in two passes: the first places every label, the second encodes.
+// Branches to the function's own .L labels are resolved here; calls and tail
+// calls to functions, this unit's included, are left to the linker as
+// R_AARCH64_CALL26 and R_AARCH64_JUMP26 relocations, as an assembler would.
+class Assembler {
+    public:
+    static ObjectCode
+    Assemble(const std::vector<Peephole::Line>& lines) {
+        Assembler assembler;
+        assembler.PlaceLabels(lines);
+        for (const Peephole::Line& line : lines) {
+            if (line.isInstruction()) {
+                assembler.Encode(line);
+            } else if (line.text.starts_with("\t.align ")) {
+                assembler.code.text.resize(Align(assembler.code.text.size(), line.text), 0);
+            }
+        }
+        return std::move(assembler.code);
+    }
+
+    private:
+    static constexpr std::uint32_t Call26 = 283;
+    static constexpr std::uint32_t Jump26 = 282;
+    static constexpr std::uint32_t ZeroOrSp = 31;
+
+    ObjectCode code;
+    // Offsets of the .L labels.
+    std::unordered_map<std::string, std::uint64_t> labels;
+
+    // Offset after an ".align n" directive at offset.
+    static std::uint64_t
+    Align(std::uint64_t offset, const std::string& directive) {
+        const std::uint64_t alignment = std::uint64_t{1} << std::stoi(directive.substr(8));
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    void
+    PlaceLabels(const std::vector<Peephole::Line>& lines) {
+        std::uint64_t offset = 0;
+        std::vector<std::string> global;
+        std::optional<std::uint32_t> function;
+        for (const Peephole::Line& line : lines) {
+            if (line.isInstruction()) {
+                offset += 4;
+            } else if (line.text.starts_with("\t.align ")) {
+                const std::uint64_t alignment = std::uint64_t{1} << std::stoi(line.text.substr(8));
+                code.alignment = std::max(code.alignment, alignment);
+                offset = Align(offset, line.text);
+            } else if (line.text.starts_with("\t.globl ")) {
+                global.push_back(line.text.substr(8));
+            } else if (line.text.ends_with(":")) {
+                const std::string name = line.text.substr(0, line.text.size() - 1);
+                if (name.starts_with(".L")) {
+                    labels[name] = offset;
+                    continue;
+                }
+                if (function) {
+                    code.symbols[*function].size = offset - code.symbols[*function].offset;
+                }
+                function = code.SymbolIndex(name);
+                code.symbols[*function].defined = true;
+                code.symbols[*function].offset = offset;
+            } else if (!line.text.empty()) {
+                throw std::runtime_error("Cannot assemble '" + line.text + "'");
+            }
+        }
+        if (function) {
+            code.symbols[*function].size = offset - code.symbols[*function].offset;
+        }
+        for (const std::string& name : global) {
+            code.symbols[code.SymbolIndex(name)].global = true;
+        }
+    }
+
+    void
+    Emit(std::uint32_t instruction) {
+        for (int i = 0; i < 4; ++i) {
+            code.text.push_back(static_cast<std::uint8_t>(instruction >> (8 * i)));
+        }
+    }
+
+    [[noreturn]] static void
+    Unsupported(const Peephole::Line& line) {
+        throw std::runtime_error("Cannot encode '" + line.text.substr(1) + "'");
+    }
+
+    // xN, xzr or sp; the latter two are both register 31, which one is meant
+    // depends on the instruction.
+    static std::uint32_t
+    Register(const std::string& operand) {
+        if (operand == "xzr" || operand == "sp") {
+            return ZeroOrSp;
+        }
+        if (operand.size() < 2 || operand[0] != 'x') {
+            throw std::runtime_error("Expected a register, got '" + operand + "'");
+        }
+        const int reg = std::stoi(operand.substr(1));
+        if (reg < 0 || reg > 30) {
+            throw std::runtime_error("No register " + operand);
+        }
+        return static_cast<std::uint32_t>(reg);
+    }
+
+    // #n, in decimal or hexadecimal.
+    static std::int64_t
+    Immediate(const std::string& operand) {
+        if (!operand.starts_with("#")) {
+            throw std::runtime_error("Expected an immediate, got '" + operand + "'");
+        }
+        return std::stoll(operand.substr(1), nullptr, 0);
+    }
+
+    // The k of a "lsl #k" operand.
+    static std::uint32_t
+    Shift(const std::string& operand) {
+        if (!operand.starts_with("lsl ")) {
+            throw std::runtime_error("Expected a shift, got '" + operand + "'");
+        }
+        return static_cast<std::uint32_t>(Immediate(operand.substr(4)));
+    }
+
+    // [base], [base, #offset] or [base, #offset]!
+    struct Address {
+        std::uint32_t base;
+        std::int64_t offset;
+        bool preIndex;
+    };
+
+    static Address
+    ParseAddress(const std::string& operand) {
+        const bool preIndex = operand.ends_with("!");
+        const std::size_t close = operand.find(']');
+        if (!operand.starts_with("[") || close == std::string::npos) {
+            throw std::runtime_error("Expected an address, got '" + operand + "'");
+        }
+        const std::string inside = operand.substr(1, close - 1);
+        const std::size_t comma = inside.find(", ");
+        if (comma == std::string::npos) {
+            return {Register(inside), 0, preIndex};
+        }
+        return {Register(inside.substr(0, comma)), Immediate(inside.substr(comma + 2)), preIndex};
+    }
+
+    void
+    Encode(const Peephole::Line& line) {
+        const std::string& op = line.mnemonic;
+        const std::vector<std::string>& operands = line.operands;
+        const auto reg = [&](std::size_t i) { return Register(operands.at(i)); };
+
+        if (op == "ret" && operands.empty()) {
+            Emit(0xD65F03C0);
+        } else if (op == "svc" && operands.size() == 1) {
+            Emit(0xD4000001 | static_cast<std::uint32_t>(Immediate(operands[0]) & 0xFFFF) << 5);
+        } else if ((op == "b" || op == "bl") && operands.size() == 1) {
+            Branch(op == "bl", operands[0]);
+        } else if (op == "mov" && operands.size() == 2) {
+            Move(line);
+        } else if ((op == "movz" || op == "movk") && operands.size() == 3) {
+            const std::uint32_t shift = Shift(operands[2]);
+            const std::uint32_t base = op == "movz" ? 0xD2800000 : 0xF2800000;
+            Emit(base | shift / 16 << 21 | static_cast<std::uint32_t>(Immediate(operands[1]) & 0xFFFF) << 5 | reg(0));
+        } else if (op == "add" || op == "sub") {
+            AddSubtract(line);
+        } else if (op == "neg" && operands.size() == 2) {
+            Emit(0xCB000000 | reg(1) << 16 | ZeroOrSp << 5 | reg(0));
+        } else if (op == "mul" && operands.size() == 3) {
+            Emit(0x9B000000 | reg(2) << 16 | ZeroOrSp << 10 | reg(1) << 5 | reg(0));
+        } else if ((op == "madd" || op == "msub") && operands.size() == 4) {
+            Emit((op == "madd" ? 0x9B000000 : 0x9B008000) | reg(2) << 16 | reg(3) << 10 | reg(1) << 5 | reg(0));
+        } else if (op == "smulh" && operands.size() == 3) {
+            Emit(0x9B407C00 | reg(2) << 16 | reg(1) << 5 | reg(0));
+        } else if (op == "sdiv" && operands.size() == 3) {
+            Emit(0x9AC00C00 | reg(2) << 16 | reg(1) << 5 | reg(0));
+        } else if ((op == "lsl" || op == "lsr" || op == "asr") && operands.size() == 3) {
+            ShiftInstruction(line);
+        } else if ((op == "ldr" || op == "str") && (operands.size() == 2 || operands.size() == 3)) {
+            LoadStore(line);
+        } else if ((op == "ldp" || op == "stp") && (operands.size() == 3 || operands.size() == 4)) {
+            LoadStorePair(line);
+        } else {
+            Unsupported(line);
+        }
+    }
+
+    void
+    Branch(bool link, const std::string& target) {
+        const std::uint32_t opcode = link ? 0x94000000 : 0x14000000;
+        const auto label = labels.find(target);
+        if (label == labels.end()) {
+            code.relocations.push_back({code.text.size(), code.SymbolIndex(target), link ? Call26 : Jump26});
+            Emit(opcode);
+            return;
+        }
+        const std::int64_t distance = static_cast<std::int64_t>(label->second) - static_cast<std::int64_t>(code.text.size());
+        if (distance < -(std::int64_t{1} << 27) || distance >= std::int64_t{1} << 27) {
+            throw std::runtime_error("Branch to " + target + " is out of range");
+        }
+        Emit(opcode | (static_cast<std::uint32_t>(distance / 4) & 0x3FFFFFF));
+    }
+
+    // mov xD, xS is orr from xzr, or add #0 when sp is involved; mov xD, #n
+    // is movz, or movn for negative n.
+    void
+    Move(const Peephole::Line& line) {
+        const std::string& to = line.operands[0];
+        const std::string& from = line.operands[1];
+        if (from.starts_with("#")) {
+            const std::int64_t value = Immediate(from);
+            if (value >= 0 && value <= 0xFFFF) {
+                Emit(0xD2800000 | static_cast<std::uint32_t>(value) << 5 | Register(to));
+            } else if (value < 0 && ~value <= 0xFFFF) {
+                Emit(0x92800000 | static_cast<std::uint32_t>(~value) << 5 | Register(to));
+            } else {
+                Unsupported(line);
+            }
+        } else if (to == "sp" || from == "sp") {
+            Emit(0x91000000 | Register(from) << 5 | Register(to));
+        } else {
+            Emit(0xAA0003E0 | Register(from) << 16 | Register(to));
+        }
+    }
+
+    // add and sub with a 12-bit immediate, a register shifted left, or, when
+    // sp is an operand, a register extended with uxtx, the form where
+    // register 31 means sp.
+    void
+    AddSubtract(const Peephole::Line& line) {
+        const std::vector<std::string>& operands = line.operands;
+        if (operands.size() != 3 && operands.size() != 4) {
+            Unsupported(line);
+        }
+        const bool subtract = line.mnemonic == "sub";
+        const std::uint32_t d = Register(operands[0]);
+        const std::uint32_t n = Register(operands[1]);
+        if (operands[2].starts_with("#")) {
+            const std::int64_t value = Immediate(operands[2]);
+            if (operands.size() != 3 || value < 0 || value > 4095) {
+                Unsupported(line);
+            }
+            Emit((subtract ? 0xD1000000 : 0x91000000) | static_cast<std::uint32_t>(value) << 10 | n << 5 | d);
+            return;
+        }
+        const std::uint32_t m = Register(operands[2]);
+        const std::uint32_t shift = operands.size() == 4 ? Shift(operands[3]) : 0;
+        if (operands[0] == "sp" || operands[1] == "sp") {
+            if (shift > 4) {
+                Unsupported(line);
+            }
+            Emit((subtract ? 0xCB206000 : 0x8B206000) | m << 16 | shift << 10 | n << 5 | d);
+            return;
+        }
+        if (shift > 63) {
+            Unsupported(line);
+        }
+        Emit((subtract ? 0xCB000000 : 0x8B000000) | m << 16 | shift << 10 | n << 5 | d);
+    }
+
+    // By a register, lslv, lsrv and asrv; by a constant, the bitfield moves
+    // the shift aliases stand for.
+    void
+    ShiftInstruction(const Peephole::Line& line) {
+        const std::string& op = line.mnemonic;
+        const std::uint32_t d = Register(line.operands[0]);
+        const std::uint32_t n = Register(line.operands[1]);
+        if (!line.operands[2].starts_with("#")) {
+            const std::uint32_t kind = op == "lsl" ? 0x2000 : op == "lsr" ? 0x2400 : 0x2800;
+            Emit(0x9AC00000 | kind | Register(line.operands[2]) << 16 | n << 5 | d);
+            return;
+        }
+        const auto amount = static_cast<std::uint32_t>(Immediate(line.operands[2]) & 63);
+        if (op == "lsl") {
+            Emit(0xD3400000 | (64 - amount) % 64 << 16 | (63 - amount) << 10 | n << 5 | d);
+        } else {
+            Emit((op == "lsr" ? 0xD3400000 : 0x93400000) | amount << 16 | 63 << 10 | n << 5 | d);
+        }
+    }
+
+    // ldr and str of a 64-bit register: a scaled unsigned offset when it
+    // fits, else an unscaled one, or pre- and post-indexed.
+    void
+    LoadStore(const Peephole::Line& line) {
+        const bool load = line.mnemonic == "ldr";
+        const std::uint32_t t = Register(line.operands[0]);
+        const Address address = ParseAddress(line.operands[1]);
+        const auto unscaled = [&](std::int64_t offset, std::uint32_t mode) {
+            if (offset < -256 || offset > 255) {
+                Unsupported(line);
+            }
+            Emit((load ? 0xF8400000 : 0xF8000000) | (static_cast<std::uint32_t>(offset) & 0x1FF) << 12 | mode << 10 |
+                 address.base << 5 | t);
+        };
+        if (line.operands.size() == 3) {
+            unscaled(Immediate(line.operands[2]), 1);
+        } else if (address.preIndex) {
+            unscaled(address.offset, 3);
+        } else if (address.offset >= 0 && address.offset % 8 == 0 && address.offset / 8 <= 4095) {
+            Emit((load ? 0xF9400000 : 0xF9000000) | static_cast<std::uint32_t>(address.offset / 8) << 10 | address.base << 5 | t);
+        } else {
+            unscaled(address.offset, 0);
+        }
+    }
+
+    // ldp and stp of two 64-bit registers, at a signed offset or pre- or
+    // post-indexed.
+    void
+    LoadStorePair(const Peephole::Line& line) {
+        const bool load = line.mnemonic == "ldp";
+        const Address address = ParseAddress(line.operands[2]);
+        std::int64_t offset = address.offset;
+        std::uint32_t mode = address.preIndex ? 3 : 2;
+        if (line.operands.size() == 4) {
+            offset = Immediate(line.operands[3]);
+            mode = 1;
+        }
+        if (offset % 8 != 0 || offset < -512 || offset > 504) {
+            Unsupported(line);
+        }
+        Emit(0xA8000000 | mode << 23 | (load ? 1u : 0u) << 22 | (static_cast<std::uint32_t>(offset / 8) & 0x7F) << 15 |
+             Register(line.operands[1]) << 10 | address.base << 5 | Register(line.operands[0]));
+    }
+};
+
+#endif //ASSEMBLER_HPP
@@ -0,0 +1,129 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef COMPILEROPTIONS_HPP
+#define COMPILEROPTIONS_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// How hard to optimize; see Pipeline for the passes each level runs.
+enum class OptimizationLevel : std::uint8_t { O0, O1, O2, Os };
+
+// Machine to generate code for. Both follow Linux conventions; AArch64 code
+// is assembled in process, x86-64 code is GAS assembly.
+enum class Target : std::uint8_t { AArch64, X86_64 };
+
+// Settings for one compilation, from the command line or a target's
+// compiler_flags.
+struct CompilerOptions {
+    // Also write the optimized IR next to the object, as <stem>.ir.
+    bool emitIR = false;
+    // Also write the assembly the object was encoded from, as <stem>.s.
+    bool emitAssembly = false;
+    // Print each function's register allocation: values, spills and the
+    // callee-saved registers it has to save.
+    bool reportSpills = false;
+    // Print how many AST nodes each unit parsed into how many arena bytes.
+    bool reportArena = false;
+    // Print the instructions and stack bytes dead code elimination removed
+    // from each function.
+    bool reportDeadCode = false;
+    // Print each call that was evaluated at compile time, and its value.
+    bool reportFoldedCalls = false;
+    // Print how often each peephole rule fired.
+    bool reportPeephole = false;
+    // Print the passes that will run, in order.
+    bool printPasses = false;
+    OptimizationLevel optimization = OptimizationLevel::O2;
+    Target target = Target::AArch64;
+    // -f<pass> and -fno-<pass>, in the order given: the pass and whether it
+    // runs. A later toggle of the same pass wins.
+    std::vector<std::pair<std::string, bool>> passToggles;
+    // Largest function, in IR instructions, that is inlined into its
+    // callers; unset, the optimization level decides.
+    std::optional<std::uint32_t> inlineLimit;
+    // Every flag Parse accepted, in order, so a build can pass them on.
+    std::vector<std::string> flags;
+
+    // The binutils program name (as, ld, ar) that handles target's objects:
+    // the host's own when it runs target's code, the GNU cross tool, such
+    // as aarch64-linux-gnu-ld, otherwise.
+    [[nodiscard]] std::string
+    Tool(std::string_view name) const {
+#if defined(__aarch64__)
+        constexpr Target host = Target::AArch64;
+#else
+        constexpr Target host = Target::X86_64;
+#endif
+        if (target == host) {
+            return std::string(name);
+        }
+        return (target == Target::AArch64 ? "aarch64-linux-gnu-" : "x86_64-linux-gnu-") + std::string(name);
+    }
+
+    // Applies flag if it is a compiler option, returning whether it was.
+    bool
+    Parse(std::string_view flag) {
+        if (flag == "--emit-ir") {
+            emitIR = true;
+        } else if (flag == "--emit-asm") {
+            emitAssembly = true;
+        } else if (flag == "--report-arena") {
+            reportArena = true;
+        } else if (flag == "--report-spills") {
+            reportSpills = true;
+        } else if (flag == "--report-dead-code") {
+            reportDeadCode = true;
+        } else if (flag == "--report-folded-calls") {
+            reportFoldedCalls = true;
+        } else if (flag == "--report-peephole") {
+            reportPeephole = true;
+        } else if (flag == "--print-passes") {
+            printPasses = true;
+        } else if (flag == "-O0") {
+            optimization = OptimizationLevel::O0;
+        } else if (flag == "-O1") {
+            optimization = OptimizationLevel::O1;
+        } else if (flag == "-O2") {
+            optimization = OptimizationLevel::O2;
+        } else if (flag == "-Os") {
+            optimization = OptimizationLevel::Os;
+        } else if (flag.starts_with("--target=")) {
+            const std::string_view name = flag.substr(9);
+            if (name == "aarch64" || name == "arm64") {
+                target = Target::AArch64;
+            } else if (name == "x86_64" || name == "x86-64") {
+                target = Target::X86_64;
+            } else {
+                throw std::runtime_error("Unknown target '" + std::string(name) + "'; expected aarch64 or x86_64");
+            }
+        } else if (flag.starts_with("-finline-limit=")) {
+            const std::string_view value = flag.substr(flag.find('=') + 1);
+            std::uint32_t limit = 0;
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), limit);
+            if (error != std::errc() || end != value.data() + value.size()) {
+                throw std::runtime_error("Invalid -finline-limit '" + std::string(value) +
+                                         "'; expected a number of IR instructions from 0 to 4294967295");
+            }
+            inlineLimit = limit;
+        } else if (flag.starts_with("-fno-") && flag.size() > 5) {
+            passToggles.emplace_back(flag.substr(5), false);
+        } else if (flag.starts_with("-f") && flag.size() > 2) {
+            passToggles.emplace_back(flag.substr(2), true);
+        } else {
+            return false;
+        }
+        flags.emplace_back(flag);
+        return true;
+    }
+};
+
+#endif //COMPILEROPTIONS_HPP
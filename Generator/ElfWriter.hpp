@@ -0,0 +1,189 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef ELFWRITER_HPP
+#define ELFWRITER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Machine code of one unit, with the symbols it defines or calls and the
+// places the linker has to patch, as an assembler would produce it.
+struct ObjectCode {
+    struct Symbol {
+        std::string name;
+        bool defined = false;
+        bool global = false;
+        // Offset and length in text, for defined symbols.
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+    };
+
+    // The linker adds the address of symbols[symbol] to the field at
+    // offset in text, in the way the machine-specific type says.
+    struct Relocation {
+        std::uint64_t offset;
+        std::uint32_t symbol;
+        std::uint32_t type;
+    };
+
+    std::vector<std::uint8_t> text;
+    std::uint64_t alignment = 4;
+    std::vector<Symbol> symbols;
+    std::vector<Relocation> relocations;
+
+    // Index of the symbol called name, added as undefined if it is new.
+    std::uint32_t
+    SymbolIndex(std::string_view name) {
+        const auto found = std::ranges::find(symbols, name, &Symbol::name);
+        if (found != symbols.end()) {
+            return static_cast<std::uint32_t>(found - symbols.begin());
+        }
+        symbols.push_back({std::string(name)});
+        return static_cast<std::uint32_t>(symbols.size() - 1);
+    }
+};
+
+// Writes ObjectCode as a relocatable little-endian ELF64 file with the
+// sections .text, .rela.text, .symtab, .strtab, .shstrtab and an empty
+// .note.GNU-stack, which tells the linker the stack need not be executable.
+class ElfWriter {
+    public:
+    static constexpr std::uint16_t MachineAArch64 = 183;
+
+    static std::vector<std::uint8_t>
+    Write(const ObjectCode& code, std::uint16_t machine) {
+        // A symbol the unit only refers to has to be found in another one,
+        // so it is global too. Local symbols must come before global ones.
+        const auto global = [](const ObjectCode::Symbol& symbol) { return symbol.global || !symbol.defined; };
+        std::vector<std::uint32_t> order;
+        for (std::uint32_t i = 0; i < code.symbols.size(); ++i) {
+            order.push_back(i);
+        }
+        std::ranges::stable_partition(order, [&](std::uint32_t i) { return !global(code.symbols[i]); });
+        std::vector<std::uint32_t> symbolIndex(code.symbols.size());
+        for (std::uint32_t i = 0; i < order.size(); ++i) {
+            symbolIndex[order[i]] = i + 1;
+        }
+        const auto firstGlobal = static_cast<std::uint32_t>(
+            1 + std::ranges::count_if(code.symbols, [&](const ObjectCode::Symbol& symbol) { return !global(symbol); }));
+
+        std::string strings(1, '\0');
+        std::vector<std::uint8_t> symtab(SymbolSize, 0);
+        for (const std::uint32_t i : order) {
+            const ObjectCode::Symbol& symbol = code.symbols[i];
+            Append<std::uint32_t>(symtab, static_cast<std::uint32_t>(strings.size()));
+            strings += symbol.name;
+            strings += '\0';
+            const std::uint8_t binding = global(symbol) ? 1 : 0;          // STB_GLOBAL, STB_LOCAL
+            const std::uint8_t type = symbol.defined ? 2 : 0;             // STT_FUNC, STT_NOTYPE
+            Append<std::uint8_t>(symtab, static_cast<std::uint8_t>(binding << 4 | type));
+            Append<std::uint8_t>(symtab, 0);
+            Append<std::uint16_t>(symtab, symbol.defined ? TextSection : 0);
+            Append<std::uint64_t>(symtab, symbol.offset);
+            Append<std::uint64_t>(symtab, symbol.size);
+        }
+
+        std::vector<std::uint8_t> rela;
+        for (const ObjectCode::Relocation& relocation : code.relocations) {
+            Append<std::uint64_t>(rela, relocation.offset);
+            Append<std::uint64_t>(rela, std::uint64_t{symbolIndex[relocation.symbol]} << 32 | relocation.type);
+            Append<std::int64_t>(rela, 0);
+        }
+
+        std::string sectionNames(1, '\0');
+        const auto name = [&](std::string_view section) {
+            const auto offset = static_cast<std::uint32_t>(sectionNames.size());
+            sectionNames += section;
+            sectionNames += '\0';
+            return offset;
+        };
+        std::vector<Section> sections = {
+            {},
+            {name(".text"), 1, 0x6, code.text, 0, 0, code.alignment, 0},                              // PROGBITS, ALLOC | EXECINSTR
+            {name(".rela.text"), 4, 0x40, rela, SymtabSection, TextSection, 8, RelocationSize},      // RELA, INFO_LINK
+            {name(".symtab"), 2, 0, symtab, StrtabSection, firstGlobal, 8, SymbolSize},               // SYMTAB
+            {name(".strtab"), 3, 0, {strings.begin(), strings.end()}, 0, 0, 1, 0},                   // STRTAB
+            {name(".shstrtab"), 3, 0, {}, 0, 0, 1, 0},
+            {name(".note.GNU-stack"), 1, 0, {}, 0, 0, 1, 0},
+        };
+        sections[ShstrtabSection].data.assign(sectionNames.begin(), sectionNames.end());
+
+        std::vector<std::uint8_t> file(HeaderSize, 0);
+        std::vector<std::uint64_t> offsets(sections.size(), 0);
+        for (std::size_t i = 1; i < sections.size(); ++i) {
+            file.resize((file.size() + sections[i].alignment - 1) / sections[i].alignment * sections[i].alignment, 0);
+            offsets[i] = file.size();
+            file.insert(file.end(), sections[i].data.begin(), sections[i].data.end());
+        }
+        file.resize((file.size() + 7) & ~std::size_t{7}, 0);
+        const std::uint64_t sectionHeaders = file.size();
+        for (std::size_t i = 0; i < sections.size(); ++i) {
+            const Section& section = sections[i];
+            Append<std::uint32_t>(file, section.name);
+            Append<std::uint32_t>(file, section.type);
+            Append<std::uint64_t>(file, section.flags);
+            Append<std::uint64_t>(file, 0);
+            Append<std::uint64_t>(file, offsets[i]);
+            Append<std::uint64_t>(file, section.data.size());
+            Append<std::uint32_t>(file, section.link);
+            Append<std::uint32_t>(file, section.info);
+            Append<std::uint64_t>(file, section.alignment);
+            Append<std::uint64_t>(file, section.entrySize);
+        }
+
+        std::vector<std::uint8_t> header = {0x7F, 'E', 'L', 'F', 2, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0}; // 64-bit, little-endian
+        Append<std::uint16_t>(header, 1);                                                           // ET_REL
+        Append<std::uint16_t>(header, machine);
+        Append<std::uint32_t>(header, 1);
+        Append<std::uint64_t>(header, 0);
+        Append<std::uint64_t>(header, 0);
+        Append<std::uint64_t>(header, sectionHeaders);
+        Append<std::uint32_t>(header, 0);
+        Append<std::uint16_t>(header, HeaderSize);
+        Append<std::uint16_t>(header, 0);
+        Append<std::uint16_t>(header, 0);
+        Append<std::uint16_t>(header, SectionHeaderSize);
+        Append<std::uint16_t>(header, static_cast<std::uint16_t>(sections.size()));
+        Append<std::uint16_t>(header, ShstrtabSection);
+        std::ranges::copy(header, file.begin());
+        return file;
+    }
+
+    private:
+    static constexpr std::uint16_t HeaderSize = 64;
+    static constexpr std::uint16_t SectionHeaderSize = 64;
+    static constexpr std::uint64_t SymbolSize = 24;
+    static constexpr std::uint64_t RelocationSize = 24;
+    static constexpr std::uint16_t TextSection = 1;
+    static constexpr std::uint32_t SymtabSection = 3;
+    static constexpr std::uint32_t StrtabSection = 4;
+    static constexpr std::uint16_t ShstrtabSection = 5;
+
+    struct Section {
+        std::uint32_t name = 0;
+        std::uint32_t type = 0;
+        std::uint64_t flags = 0;
+        std::vector<std::uint8_t> data;
+        std::uint32_t link = 0;
+        std::uint32_t info = 0;
+        std::uint64_t alignment = 1;
+        std::uint64_t entrySize = 0;
+    };
+
+    // Appends value in little-endian byte order.
+    template <typename T>
+    static void
+    Append(std::vector<std::uint8_t>& bytes, T value) {
+        const auto bits = static_cast<std::uint64_t>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            bytes.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+        }
+    }
+};
+
+#endif //ELFWRITER_HPP
@@ -0,0 +1,130 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef FRAMELAYOUT_HPP
+#define FRAMELAYOUT_HPP
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "RegisterAllocator.hpp"
+
+// Places a function's stack slots and spill slots in its frame, below the
+// callee-saved registers, and sizes the frame.
+//
+// Each slot takes its type's natural size and alignment. Slots are live over
+// a range of the allocator's instruction numbering: a stack slot from its
+// first store or the start of a block it is live into, to its last load or
+// the end of a block it is live out of; a spill slot over its value's
+// interval. Taken by start, a slot reuses a cell of its size whose previous
+// occupants are all dead before it starts, or else gets a new cell, so
+// locals of disjoint scopes and values spilled in different parts of the
+// function share memory.
+class FrameLayout {
+    public:
+    // Offsets from the frame pointer, x29 or rbp, negative.
+    std::vector<int> slotOffsets;
+    std::vector<int> spillOffsets;
+    // Bytes the stack pointer moves down below the frame pointer, a
+    // multiple of 16.
+    int size = 0;
+
+    // Size and alignment of a value of type in memory.
+    static int
+    SizeOf(IRType type) {
+        if (type != IRType::I64) {
+            throw std::runtime_error("No stack slot can hold a void value");
+        }
+        return 8;
+    }
+
+    FrameLayout(const IRFunction& function, const Allocation& allocation) {
+        slotOffsets.assign(function.slots.size(), 0);
+        spillOffsets.assign(allocation.spillSlots, 0);
+        std::vector<Item> items;
+        const std::vector<LiveRange> slotRanges = SlotRanges(function);
+        for (SlotId slot = 0; slot < function.slots.size(); ++slot) {
+            items.push_back({SizeOf(function.slots[slot].type), slotRanges[slot], &slotOffsets[slot]});
+        }
+        for (std::uint32_t spill = 0; spill < allocation.spillSlots; ++spill) {
+            items.push_back({8, allocation.spillRanges[spill], &spillOffsets[spill]});
+        }
+
+        std::vector<std::size_t> order(items.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::ranges::stable_sort(order, {}, [&](std::size_t i) { return items[i].range.start; });
+
+        // Callee-saved registers take 8 bytes each at the top of the frame.
+        int used = 8 * static_cast<int>(allocation.calleeSaved.size());
+        std::vector<Cell> cells;
+        for (const std::size_t i : order) {
+            const Item& item = items[i];
+            auto cell = std::ranges::find_if(cells, [&](const Cell& cell) {
+                return cell.size == item.size && cell.end < item.range.start;
+            });
+            if (cell == cells.end()) {
+                used = (used + item.size + item.size - 1) / item.size * item.size;
+                cells.push_back({item.size, -used, 0});
+                cell = cells.end() - 1;
+            }
+            cell->end = item.range.end;
+            *item.offset = cell->offset;
+        }
+        size = (used + 15) & ~15;
+    }
+
+    private:
+    struct Item {
+        int size;
+        LiveRange range;
+        int* offset;
+    };
+
+    struct Cell {
+        int size;
+        int offset;
+        // Where the last slot placed here stops being live.
+        std::uint32_t end;
+    };
+
+    // Hull of the positions where each stack slot is live or accessed. A
+    // store counts even if nothing reads it, as it still writes the memory.
+    static std::vector<LiveRange>
+    SlotRanges(const IRFunction& function) {
+        std::vector<LiveRange> ranges(function.slots.size(), {std::numeric_limits<std::uint32_t>::max(), 0});
+        const auto cover = [&](SlotId slot, std::uint32_t position) {
+            ranges[slot].start = std::min(ranges[slot].start, position);
+            ranges[slot].end = std::max(ranges[slot].end, position);
+        };
+        const SlotLiveness liveness(function);
+        std::vector<std::uint32_t> blockStart;
+        std::vector<std::uint32_t> blockEnd;
+        RegisterAllocator::NumberBlocks(function, blockStart, blockEnd);
+        std::uint32_t index = 0;
+        for (const BasicBlock& block : function.blocks) {
+            liveness.liveIn[block.id].ForEach([&](SlotId slot) { cover(slot, blockStart[block.id]); });
+            liveness.liveOut[block.id].ForEach([&](SlotId slot) { cover(slot, blockEnd[block.id]); });
+            for (const Instruction& instruction : block.instructions) {
+                const std::uint32_t position = 2 * index++;
+                if (instruction.op == Opcode::Load) {
+                    cover(instruction.slot, position);
+                } else if (instruction.op == Opcode::Store) {
+                    cover(instruction.slot, position + 1);
+                }
+            }
+        }
+        // A slot nothing touches still gets a place; it conflicts with nothing.
+        for (LiveRange& range : ranges) {
+            if (range.start > range.end) {
+                range = {0, 0};
+            }
+        }
+        return ranges;
+    }
+};
+
+#endif //FRAMELAYOUT_HPP
@@ -6,179 +6,582 @@
 #ifndef GENERATOR_CPP
 #define GENERATOR_CPP
 
-#include <sstream>
-#include <unordered_map>
+#include <format>
+#include <iostream>
+#include <vector>
 #include "../Parser/Parser.cpp"
+#include "../IR/Lowering.hpp"
+#include "../IR/PassManager.hpp"
+#include "../Optimizer/CallEvaluation.hpp"
+#include "../Optimizer/ConstantFolding.hpp"
+#include "../Optimizer/DeadCodeElimination.hpp"
+#include "../Optimizer/Inliner.hpp"
+#include "../Optimizer/Pipeline.hpp"
+#include "../Optimizer/PromoteSlots.hpp"
+#include "../Optimizer/SimplifyCFG.hpp"
+#include "../Optimizer/StrengthReduction.hpp"
+#include "../Optimizer/TailRecursion.hpp"
+#include "../Optimizer/ValueNumbering.hpp"
+#include "Assembler.hpp"
+#include "CompilerOptions.hpp"
+#include "ElfWriter.hpp"
+#include "FrameLayout.hpp"
+#include "ParallelCopy.hpp"
+#include "Peephole.hpp"
+#include "RegisterAllocator.hpp"
+#include "X86Generator.hpp"
 
+// AArch64 backend. Consumes verified IR whose registers have been assigned
+// by the RegisterAllocator. Spilled values and locals that were not promoted
+// live in the frame below the callee-saved registers, addressed from x29;
+// x16 and x17 hold spilled or constant operands while an instruction
+// executes, and x8 addresses frame slots that are too far for an offset.
+//
+// Calls follow AAPCS64: the first eight arguments go in x0-x7 and the rest
+// in 8-byte stack slots above the callee's frame record, first lowest; the
+// result comes back in x0. The allocator never hands out x0-x7, so argument
+// registers are only written right before the call and read right after
+// entry.
+//
+// Output follows Linux conventions, as the x86-64 backend's does: symbols
+// are function names as they are, local labels start with .L, main exits
+// through the exit system call, number 93, and the unit that defines main
+// also defines _start, which calls it.
 class Generator {
     public:
-    static std::string
-    GenerateAssembly(const std::unique_ptr<CompilationUnit>& program) {
-        assembly.str("");
-        assembly.clear();
-        EmitLine("\t.globl _main");
-        EmitLine("\t.align 4");
-
-        for (auto& node : program->nodes) {
-            if (dynamic_cast<FunctionDef*>(node.get())) {
-                GenerateFunction(std::unique_ptr<FunctionDef>(dynamic_cast<FunctionDef *>(node.release())));
-            } else {
-                GenerateStatement(std::unique_ptr<Statement>(dynamic_cast<Statement *>(node.release())));
+    // Lowers program to IR and runs the passes selected by options.
+    static IRModule
+    BuildIR(const CompilationUnit& program, const CompilerOptions& options = {}) {
+        IRModule module = Lowering::Lower(program);
+        const std::vector<std::string_view> pipeline = Pipeline::Passes(options);
+        if (options.printPasses) {
+            std::string names;
+            for (const std::string_view name : pipeline) {
+                names += " " + std::string(name);
             }
+            std::cout << "Passes:" << (names.empty() ? " none" : names) << "\n";
+        }
+        PassManager passes;
+        std::vector<DeadCodeElimination::Removed> removed;
+        std::vector<CallEvaluation::Folded> folded;
+        for (const std::string_view name : pipeline) {
+            if (name == "dce") {
+                passes.Add(std::make_unique<DeadCodeElimination>(&removed));
+            } else if (name == "mem2reg") {
+                passes.Add(std::make_unique<PromoteSlots>());
+            } else if (name == "tail-recursion") {
+                passes.Add(std::make_unique<TailRecursion>());
+            } else if (name == "value-numbering") {
+                passes.Add(std::make_unique<ValueNumbering>());
+            } else if (name == "inline") {
+                passes.Add(std::make_unique<Inliner>(Pipeline::InlineLimit(options)));
+            } else if (name == "simplify-cfg") {
+                passes.Add(std::make_unique<SimplifyCFG>());
+            } else if (name == "constant-folding") {
+                passes.Add(std::make_unique<ConstantFolding>());
+            } else if (name == "evaluate-calls") {
+                passes.Add(std::make_unique<CallEvaluation>(Interpreter::Limits{}, &folded));
+            } else if (name == "strength-reduction") {
+                passes.Add(std::make_unique<StrengthReduction>());
+            }
+        }
+        passes.Run(module);
+        if (options.reportFoldedCalls) {
+            for (const auto& [caller, callee, value] : folded) {
+                std::cout << std::format("Evaluated call to {} in {}: {}\n",
+                                         Interner::spelling(callee), Interner::spelling(caller), value);
+            }
+        }
+        if (options.reportDeadCode) {
+            for (const auto& [name, instructions, stackBytes] : removed) {
+                std::cout << std::format("Dead code in {}: removed {} instructions, {} bytes of stack\n",
+                                         Interner::spelling(name), instructions, stackBytes);
+            }
+        }
+        return module;
+    }
+
+    // Emits assembly for program, for options.target. The tree is only read,
+    // so it can be generated again or handed to other passes afterwards.
+    static std::string
+    GenerateAssembly(const CompilationUnit& program, const CompilerOptions& options = {}) {
+        return GenerateAssembly(BuildIR(program, options), options);
+    }
+
+    static std::string
+    GenerateAssembly(const IRModule& module, const CompilerOptions& options = {}) {
+        if (options.target == Target::X86_64) {
+            return X86Generator::GenerateAssembly(module, options);
         }
-        return assembly.str();
+        return Print(GenerateLines(module, options));
     }
+
+    // Assembles module into a relocatable ELF object in process. If assembly
+    // is given, the instructions that were encoded are also printed to it.
+    static std::vector<std::uint8_t>
+    GenerateObject(const IRModule& module, const CompilerOptions& options = {}, std::string* assembly = nullptr) {
+        if (options.target != Target::AArch64) {
+            throw std::runtime_error("The integrated assembler only encodes AArch64");
+        }
+        const std::vector<Peephole::Line> lines = GenerateLines(module, options);
+        if (assembly != nullptr) {
+            *assembly = Print(lines);
+        }
+        return ElfWriter::Write(Assembler::Assemble(lines), ElfWriter::MachineAArch64);
+    }
+
     private:
-    inline static std::stringstream assembly;
-    inline static std::unordered_map<std::string, std::unordered_map<std::string, int>> functionVariables;
-    inline static int stackSize;
-    inline static int labelCounter;
-    inline static std::string currentFunction;
+    std::vector<Peephole::Line> lines;
+    bool tailCalls = false;
+    const IRFunction* function = nullptr;
+    std::string functionName;
+    Allocation allocation;
+    std::vector<int> slotOffsets;
+    std::vector<int> spillOffsets;
+
+    static std::vector<Peephole::Line>
+    GenerateLines(const IRModule& module, const CompilerOptions& options) {
+        Generator generator;
+        generator.tailCalls = Pipeline::Runs(options, "tail-calls");
+        generator.EmitLine("\t.align 4");
+
+        for (const IRFunction& function : module.functions) {
+            generator.GenerateFunction(function);
+            if (options.reportSpills) {
+                generator.ReportAllocation();
+            }
+        }
+        if (Pipeline::Runs(options, "peephole")) {
+            Peephole peephole;
+            peephole.Run(generator.lines);
+            if (options.reportPeephole) {
+                peephole.Report(std::cout);
+            }
+        }
+        return std::move(generator.lines);
+    }
+
+    static std::string
+    Print(const std::vector<Peephole::Line>& lines) {
+        std::string assembly;
+        for (const Peephole::Line& line : lines) {
+            assembly += line.text;
+            assembly += '\n';
+        }
+        return assembly;
+    }
 
-    static void
+    void
     EmitLine(const std::string& line) {
-        assembly << line << "\n";
-    }
-
-    static void
-    AllocateVariable(const std::string& name) {
-        stackSize += 16;
-        functionVariables[currentFunction][name] = -stackSize;
-    }
-
-    static void
-    GenerateExp(const std::unique_ptr<Exp>& exp) {
-        if (auto literal = dynamic_cast<Literal*>(exp.get())) {
-            EmitLine("\tmov x0, #" + std::to_string(literal->value));
-        } else if (auto var = dynamic_cast<Var*>(exp.get())) {
-            int offset = functionVariables[currentFunction][var->name];
-            EmitLine("\tldr x0, [x29, #" + std::to_string(offset) + "]");
-        } else if (auto binOp = dynamic_cast<BinOp*>(exp.get())) {
-            bool lhsSimple = dynamic_cast<Var*>(binOp->lhs.get()) || dynamic_cast<Literal*>(binOp->lhs.get());
-            bool rhsSimple = dynamic_cast<Var*>(binOp->rhs.get()) || dynamic_cast<Literal*>(binOp->rhs.get());
-
-            if (lhsSimple && rhsSimple) {
-                if (auto rhsVar = dynamic_cast<Var*>(binOp->rhs.get())) {
-                    int offset = functionVariables[currentFunction][rhsVar->name];
-                    EmitLine("\tldr x0, [x29, #" + std::to_string(offset) + "]");
-                } else if (auto rhsLiteral = dynamic_cast<Literal*>(binOp->rhs.get())) {
-                    EmitLine("\tmov x0, #" + std::to_string(rhsLiteral->value));
-                }
+        lines.push_back(Peephole::Line::Parse(line));
+    }
 
-                if (auto lhsVar = dynamic_cast<Var*>(binOp->lhs.get())) {
-                    int offset = functionVariables[currentFunction][lhsVar->name];
-                    EmitLine("\tldr x1, [x29, #" + std::to_string(offset) + "]");
-                } else if (auto lhsLiteral = dynamic_cast<Literal*>(binOp->lhs.get())) {
-                    EmitLine("\tmov x1, #" + std::to_string(lhsLiteral->value));
-                }
-            } else if (lhsSimple) {
-                GenerateExp(binOp->rhs);
-                if (auto lhsVar = dynamic_cast<Var*>(binOp->lhs.get())) {
-                    int offset = functionVariables[currentFunction][lhsVar->name];
-                    EmitLine("\tldr x1, [x29, #" + std::to_string(offset) + "]");
-                } else if (auto lhsLiteral = dynamic_cast<Literal*>(binOp->lhs.get())) {
-                    EmitLine("\tmov x1, #" + std::to_string(lhsLiteral->value));
-                }
-            } else if (rhsSimple) {
-                GenerateExp(binOp->lhs);
-                if (auto rhsVar = dynamic_cast<Var*>(binOp->rhs.get())) {
-                    int offset = functionVariables[currentFunction][rhsVar->name];
-                    EmitLine("\tldr x1, [x29, #" + std::to_string(offset) + "]");
-                } else if (auto rhsLiteral = dynamic_cast<Literal*>(binOp->rhs.get())) {
-                    EmitLine("\tmov x1, #" + std::to_string(rhsLiteral->value));
-                }
-            } else {
-                GenerateExp(binOp->rhs);
-                EmitLine("\tstr x0, [sp, #-16]!");
-                GenerateExp(binOp->lhs);
-                EmitLine("\tldr x1, [sp], #16");
+    static std::string
+    RegisterName(int reg) {
+        return "x" + std::to_string(reg);
+    }
 
+    std::string
+    Label(BlockId block) const {
+        return ".L" + functionName + "_" + std::to_string(block);
+    }
+
+    void
+    ReportAllocation() const {
+        std::uint32_t spilled = 0;
+        for (const Location& location : allocation.locations) {
+            spilled += location.kind == Location::Kind::Stack;
+        }
+        std::string saved;
+        for (const int reg : allocation.calleeSaved) {
+            saved += " " + RegisterName(reg);
+        }
+        std::cout << std::format("Register allocation for {}: {} values, {} spilled, callee-saved:{}\n",
+                                 functionName, allocation.values, spilled, saved.empty() ? " none" : saved);
+    }
+
+    void
+    MoveImmediate(std::string_view reg, std::int64_t value) {
+        if (value >= -65536 && value <= 65535) {
+            EmitLine("\tmov " + std::string(reg) + ", #" + std::to_string(value));
+            return;
+        }
+        const auto bits = static_cast<std::uint64_t>(value);
+        bool first = true;
+        for (int shift = 0; shift < 64; shift += 16) {
+            const std::uint64_t chunk = (bits >> shift) & 0xFFFF;
+            if (chunk == 0) {
+                continue;
             }
-            switch (binOp->op) {
-                case BinaryOperator::Add:
-                    EmitLine("\tadd x0, x0, x1");
-                break;
-                case BinaryOperator::Sub:
-                    EmitLine("\tsub x0, x0, x1");
-                break;
-                case BinaryOperator::Mul:
-                    EmitLine("\tmul x0, x0, x1");
-                break;
-                case BinaryOperator::Div:
-                    EmitLine("\tsdiv x0, x0, x1");
-                break;
+            EmitLine(std::string(first ? "\tmovz " : "\tmovk ") + std::string(reg) + ", #" + std::to_string(chunk) +
+                     ", lsl #" + std::to_string(shift));
+            first = false;
+        }
+    }
+
+    // Loads or stores reg at x29 + offset. When the offset does not fit the
+    // instruction the address is formed in the loaded register itself, or in
+    // x8 for a store.
+    void
+    FrameAccess(std::string_view instruction, std::string_view reg, int offset) {
+        if (offset >= -256) {
+            EmitLine("\t" + std::string(instruction) + " " + std::string(reg) + ", [x29, #" + std::to_string(offset) + "]");
+            return;
+        }
+        const std::string address = instruction == "ldr" ? std::string(reg) : "x8";
+        if (-offset <= 4095) {
+            EmitLine("\tsub " + address + ", x29, #" + std::to_string(-offset));
+        } else {
+            MoveImmediate(address, -offset);
+            EmitLine("\tsub " + address + ", x29, " + address);
+        }
+        EmitLine("\t" + std::string(instruction) + " " + std::string(reg) + ", [" + address + "]");
+    }
+
+    void
+    AdjustStack(std::string_view op, int bytes) {
+        if (bytes == 0) {
+            return;
+        }
+        if (bytes <= 4095) {
+            EmitLine("\t" + std::string(op) + " sp, sp, #" + std::to_string(bytes));
+        } else {
+            MoveImmediate("x16", bytes);
+            EmitLine("\t" + std::string(op) + " sp, sp, x16");
+        }
+    }
+
+    // Register holding operand, loading or materializing it into scratch
+    // when it has none. Zero reads as xzr unless the instruction would take
+    // register 31 to mean sp.
+    std::string
+    Use(const Operand& operand, std::string_view scratch, bool zeroRegister = true) {
+        if (operand.isImm()) {
+            if (operand.imm == 0 && zeroRegister) {
+                return "xzr";
             }
-        } else if (auto unOp = dynamic_cast<UnOp*>(exp.get())) {
-            GenerateExp(unOp->operand);
-            if (unOp->op == UnaryOperator::Neg) {
-                EmitLine("\tneg x0, x0");
+            MoveImmediate(scratch, operand.imm);
+            return std::string(scratch);
+        }
+        const Location& location = allocation.locations[operand.reg];
+        if (location.kind == Location::Kind::Register) {
+            return RegisterName(location.index);
+        }
+        FrameAccess("ldr", scratch, spillOffsets[location.index]);
+        return std::string(scratch);
+    }
+
+    // Register to write result to; Commit stores it if it was spilled.
+    std::string
+    Def(VReg result) const {
+        const Location& location = allocation.locations[result];
+        return location.kind == Location::Kind::Register ? RegisterName(location.index) : "x16";
+    }
+
+    void
+    Commit(VReg result) {
+        const Location& location = allocation.locations[result];
+        if (location.kind == Location::Kind::Stack) {
+            FrameAccess("str", "x16", spillOffsets[location.index]);
+        }
+    }
+
+    // Callee-saved registers go at the top of the frame, in pairs, 8 bytes
+    // each; FrameLayout places everything else below them.
+    void
+    SaveCalleeSaved(std::string_view single, std::string_view pair) {
+        const auto& saved = allocation.calleeSaved;
+        for (std::size_t i = 0; i < saved.size(); i += 2) {
+            const std::string offset = "[x29, #-" + std::to_string(8 * std::min(i + 2, saved.size())) + "]";
+            if (i + 1 < saved.size()) {
+                EmitLine("\t" + std::string(pair) + " " + RegisterName(saved[i]) + ", " + RegisterName(saved[i + 1]) + ", " + offset);
+            } else {
+                EmitLine("\t" + std::string(single) + " " + RegisterName(saved[i]) + ", " + offset);
             }
-        } else if (auto assign = dynamic_cast<Assign*>(exp.get())) {
-            GenerateExp(assign->value);
-            int offset = functionVariables[currentFunction][assign->name];
-            EmitLine("\tstr x0, [x29, #" + std::to_string(offset) + "]");
-        } else if (auto funcCall = dynamic_cast<FunctionCall*>(exp.get())) {
-            if (funcCall->arguments.size() % 2 != 0) {
-                EmitLine("\tsub sp, sp, #16");
+        }
+    }
+
+    void
+    GenerateFunction(const IRFunction& irFunction) {
+        function = &irFunction;
+        functionName = std::string(Interner::spelling(function->name));
+        allocation = RegisterAllocator::Allocate(irFunction);
+        FrameLayout frame(irFunction, allocation);
+        slotOffsets = std::move(frame.slotOffsets);
+        spillOffsets = std::move(frame.spillOffsets);
+
+        if (functionName == "main") {
+            EmitLine("\t.globl _start");
+            EmitLine("_start:");
+            EmitLine("\tbl main");
+        }
+        // Every function is exported so other units can import and call it.
+        EmitLine("\t.globl " + functionName);
+        EmitLine(functionName + ":");
+
+        EmitLine("\tstp x29, x30, [sp, #-16]!");
+        EmitLine("\tmov x29, sp");
+        AdjustStack("sub", frame.size);
+        SaveCalleeSaved("str", "stp");
+        MoveParameters();
+
+        for (const BasicBlock& block : function->blocks) {
+            if (block.id != 0) {
+                EmitLine(Label(block.id) + ":");
             }
-            for (const auto& arg : funcCall->arguments) {
-                GenerateExp(arg);
-                EmitLine("\tstr x0, [sp, #-16]!");
+            for (std::size_t i = 0; i < block.instructions.size(); ++i) {
+                if (IsTailCall(block, i)) {
+                    GenerateTailCall(block.instructions[i]);
+                    ++i;
+                    continue;
+                }
+                GenerateInstruction(block, block.instructions[i]);
             }
-            EmitLine("\tbl _" + funcCall->name);
         }
     }
 
-    static void
-    GenerateStatement(const std::unique_ptr<Statement>& stmt) {
-        if (auto returnStmt = dynamic_cast<Return*>(stmt.get())) {
-            GenerateExp(returnStmt->expression);
-        } else if (auto declareStmt = dynamic_cast<Declare*>(stmt.get())) {
-            AllocateVariable(declareStmt->name);
-            if (declareStmt->initializer) {
-                GenerateExp(*declareStmt->initializer);
-                int offset = functionVariables[currentFunction][declareStmt->name];
-                EmitLine("\tstr x0, [x29, #" + std::to_string(offset) + "]");
+    // Moves each parameter that is used from where the caller passed it.
+    void
+    MoveParameters() {
+        for (std::size_t i = 0; i < function->parameters.size(); ++i) {
+            const VReg parameter = function->parameters[i];
+            if (allocation.locations[parameter].kind == Location::Kind::None) {
+                continue;
+            }
+            if (i < ArgumentRegisters) {
+                EmitLine("\tmov " + Def(parameter) + ", " + RegisterName(static_cast<int>(i)));
+            } else {
+                FrameAccess("ldr", Def(parameter), 16 + 8 * static_cast<int>(i - ArgumentRegisters));
             }
-        } else if (auto expStmt = dynamic_cast<ExpStatement*>(stmt.get())) {
-            GenerateExp(expStmt->expression);
+            Commit(parameter);
         }
     }
 
-    static void
-    GenerateFunction(const std::unique_ptr<FunctionDef>& func) {
-        currentFunction = func->name;
-        functionVariables[currentFunction].clear();
-        stackSize = 0;
+    // Restores the caller's registers and frame, leaving the return address
+    // in x30.
+    void
+    GenerateEpilogue() {
+        SaveCalleeSaved("ldr", "ldp");
+        EmitLine("\tmov sp, x29");
+        EmitLine("\tldp x29, x30, [sp], #16");
+    }
 
-        bool isMainFunction = (func->name == "main");
+    // A call whose result is returned as is can reuse the frame: it is torn
+    // down first and the callee returns straight to this function's caller.
+    // main exits instead of returning, and stack arguments would live in the
+    // frame being torn down, so only calls from other functions with all
+    // their arguments in registers qualify, and only when "tail-calls" runs.
+    bool
+    IsTailCall(const BasicBlock& block, std::size_t index) const {
+        return tailCalls && functionName != "main" && TailRecursion::IsTailCall(block, index) &&
+               block.instructions[index].operands.size() <= ArgumentRegisters;
+    }
 
-        EmitLine("_" + func->name + ":");
+    void
+    GenerateTailCall(const Instruction& call) {
+        MoveArguments(call);
+        GenerateEpilogue();
+        EmitLine("\tb " + std::string(Interner::spelling(call.callee)));
+    }
 
-        EmitLine("\tstp x29, x30, [sp, #-16]!");
-        EmitLine("\tmov x29, sp");
+    void
+    GenerateInstruction(const BasicBlock& block, const Instruction& instruction) {
+        switch (instruction.op) {
+            case Opcode::Add:
+            case Opcode::Sub:
+            case Opcode::Mul:
+            case Opcode::SDiv:
+            case Opcode::Shl:
+            case Opcode::AShr:
+            case Opcode::LShr:
+            case Opcode::MulHi:
+                GenerateArithmetic(instruction);
+                break;
+            case Opcode::Neg: {
+                const std::string operand = Use(instruction.operands[0], "x16");
+                EmitLine("\tneg " + Def(instruction.result) + ", " + operand);
+                Commit(instruction.result);
+                break;
+            }
+            case Opcode::Copy:
+                if (instruction.operands[0].isImm()) {
+                    MoveImmediate(Def(instruction.result), instruction.operands[0].imm);
+                } else {
+                    const std::string operand = Use(instruction.operands[0], "x16");
+                    if (operand != Def(instruction.result)) {
+                        EmitLine("\tmov " + Def(instruction.result) + ", " + operand);
+                    }
+                }
+                Commit(instruction.result);
+                break;
+            case Opcode::Load:
+                FrameAccess("ldr", Def(instruction.result), slotOffsets[instruction.slot]);
+                Commit(instruction.result);
+                break;
+            case Opcode::Store:
+                FrameAccess("str", Use(instruction.operands[0], "x16"), slotOffsets[instruction.slot]);
+                break;
+            case Opcode::Call:
+                GenerateCall(instruction);
+                break;
+            case Opcode::Phi:
+                // Written by the predecessors' branches.
+                break;
+            case Opcode::Br:
+                CopyPhiOperands(block.id, instruction.blocks[0]);
+                if (instruction.blocks[0] != block.id + 1) {
+                    EmitLine("\tb " + Label(instruction.blocks[0]));
+                }
+                break;
+            case Opcode::Ret:
+                if (instruction.operands[0].isImm()) {
+                    MoveImmediate("x0", instruction.operands[0].imm);
+                } else {
+                    const std::string value = Use(instruction.operands[0], "x0");
+                    if (value != "x0") {
+                        EmitLine("\tmov x0, " + value);
+                    }
+                }
+                GenerateEpilogue();
+                if (functionName == "main") {
+                    EmitLine("\tmov x8, #93");
+                    EmitLine("\tsvc #0");
+                } else {
+                    EmitLine("\tret");
+                }
+                break;
+        }
+    }
 
-        int totalStackSize = ((func->allocationSize + 15) & ~15) + 16;
-        if (totalStackSize > 16) {
-            EmitLine("\tsub sp, sp, #" + std::to_string(totalStackSize - 16));
+    // Constants that fit are encoded in add, sub and shifts directly, and a
+    // constant left operand of a commutative operation is swapped to the
+    // right.
+    void
+    GenerateArithmetic(const Instruction& instruction) {
+        Operand lhs = instruction.operands[0];
+        Operand rhs = instruction.operands[1];
+        const bool commutative = instruction.op == Opcode::Add || instruction.op == Opcode::Mul || instruction.op == Opcode::MulHi;
+        const bool shift = instruction.op == Opcode::Shl || instruction.op == Opcode::AShr || instruction.op == Opcode::LShr;
+        if (commutative && lhs.isImm()) {
+            std::swap(lhs, rhs);
+        }
+        const std::string result = Def(instruction.result);
+        if (instruction.op == Opcode::Sub && lhs.isImm() && lhs.imm == 0) {
+            EmitLine("\tneg " + result + ", " + Use(rhs, "x17"));
+        } else if ((instruction.op == Opcode::Add || instruction.op == Opcode::Sub) && rhs.isImm() &&
+                   rhs.imm >= -4095 && rhs.imm <= 4095) {
+            const std::string source = Use(lhs, "x16", false);
+            const std::int64_t value = instruction.op == Opcode::Sub ? -rhs.imm : rhs.imm;
+            EmitLine((value < 0 ? "\tsub " : "\tadd ") + result + ", " + source + ", #" + std::to_string(value < 0 ? -value : value));
+        } else if (shift && rhs.isImm()) {
+            const std::string source = Use(lhs, "x16", false);
+            EmitLine("\t" + std::string(IRPrinter::Name(instruction.op)) + " " + result + ", " + source + ", #" + std::to_string(rhs.imm & 63));
+        } else {
+            const std::string left = Use(lhs, "x16");
+            const std::string right = Use(rhs, "x17");
+            EmitLine("\t" + std::string(IRPrinter::Name(instruction.op)) + " " + result + ", " + left + ", " + right);
         }
+        Commit(instruction.result);
+    }
 
-        for (const auto& stmt : func->statements) {
-            GenerateStatement(stmt);
+    static constexpr std::size_t ArgumentRegisters = 8;
+
+    // Loads the register arguments of call into x0-x7. Every argument was
+    // computed into its own virtual register before the call, and none of
+    // those live in x0-x7, so filling one cannot overwrite another.
+    void
+    MoveArguments(const Instruction& call) {
+        for (std::size_t i = 0; i < std::min(call.operands.size(), ArgumentRegisters); ++i) {
+            const std::string target = RegisterName(static_cast<int>(i));
+            const std::string value = Use(call.operands[i], target);
+            if (value != target) {
+                EmitLine("\tmov " + target + ", " + value);
+            }
         }
+    }
 
-        if (totalStackSize > 16) {
-            EmitLine("\tadd sp, sp, #" + std::to_string(totalStackSize - 16));
+    // Arguments past the eighth are stored below sp in a 16-byte aligned
+    // area that is popped after the call.
+    void
+    GenerateCall(const Instruction& call) {
+        const std::size_t stacked = call.operands.size() > ArgumentRegisters ? call.operands.size() - ArgumentRegisters : 0;
+        const int area = static_cast<int>((8 * stacked + 15) & ~std::size_t{15});
+        AdjustStack("sub", area);
+        for (std::size_t i = 0; i < stacked; ++i) {
+            EmitLine("\tstr " + Use(call.operands[ArgumentRegisters + i], "x16") + ", [sp, #" + std::to_string(8 * i) + "]");
         }
-        EmitLine("\tldp x29, x30, [sp], #16");
+        MoveArguments(call);
+        EmitLine("\tbl " + std::string(Interner::spelling(call.callee)));
+        AdjustStack("add", area);
+        EmitLine("\tmov " + Def(call.result) + ", x0");
+        Commit(call.result);
+    }
+
+    MoveLocation
+    LocationOf(VReg reg) const {
+        const Location& location = allocation.locations[reg];
+        if (location.kind == Location::Kind::Register) {
+            return {location.index, 0};
+        }
+        return {-1, spillOffsets[location.index]};
+    }
 
-        if (isMainFunction) {
-            EmitLine("\tmov x16, #1");
-            EmitLine("\tsvc #0x80");
+    void
+    EmitMove(const Move& move) {
+        if (move.to.reg >= 0) {
+            const std::string to = RegisterName(move.to.reg);
+            if (move.constant) {
+                MoveImmediate(to, *move.constant);
+            } else if (move.from.reg >= 0) {
+                EmitLine("\tmov " + to + ", " + RegisterName(move.from.reg));
+            } else {
+                FrameAccess("ldr", to, move.from.offset);
+            }
+            return;
+        }
+        std::string from;
+        if (move.constant) {
+            from = *move.constant == 0 ? "xzr" : "x17";
+            if (*move.constant != 0) {
+                MoveImmediate(from, *move.constant);
+            }
+        } else if (move.from.reg >= 0) {
+            from = RegisterName(move.from.reg);
         } else {
-            EmitLine("\tret");
+            from = "x17";
+            FrameAccess("ldr", from, move.from.offset);
+        }
+        FrameAccess("str", from, move.to.offset);
+    }
+
+    // Moves the values the phis of target take when entered from block, as
+    // one parallel copy; cycles are broken through x16.
+    void
+    CopyPhiOperands(BlockId block, BlockId target) {
+        std::vector<Move> moves;
+        for (const Instruction& phi : function->blocks[target].instructions) {
+            if (phi.op != Opcode::Phi) {
+                break;
+            }
+            for (std::size_t i = 0; i < phi.blocks.size(); ++i) {
+                if (phi.blocks[i] != block) {
+                    continue;
+                }
+                const Operand& value = phi.operands[i];
+                Move move{LocationOf(phi.result), {}, std::nullopt};
+                if (value.isImm()) {
+                    move.constant = value.imm;
+                } else {
+                    move.from = LocationOf(value.reg);
+                    if (move.from == move.to) {
+                        continue;
+                    }
+                }
+                moves.push_back(move);
+            }
         }
+        ScheduleMoves(std::move(moves), {16, 0}, [&](const Move& move) { EmitMove(move); });
     }
 };
 
-#endif // GENERATOR_CPP
\ No newline at end of file
+#endif //GENERATOR_CPP
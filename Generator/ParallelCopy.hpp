@@ -0,0 +1,55 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef PARALLELCOPY_HPP
+#define PARALLELCOPY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// A place a copy reads or writes: a machine register or a frame slot, by
+// its offset from the frame pointer.
+struct MoveLocation {
+    int reg = -1;
+    int offset = 0;
+    bool operator==(const MoveLocation&) const = default;
+};
+
+struct Move {
+    MoveLocation to;
+    MoveLocation from;
+    std::optional<std::int64_t> constant;
+};
+
+// Emits moves as one parallel copy, so every destination gets the value its
+// source had before any of them was written: a move is emitted once nothing
+// still needs to read its destination, and cycles are broken through
+// temporary, a register none of the moves touch.
+template <typename EmitMove>
+void
+ScheduleMoves(std::vector<Move> moves, MoveLocation temporary, EmitMove emit) {
+    while (!moves.empty()) {
+        const auto ready = std::ranges::find_if(moves, [&](const Move& move) {
+            return std::ranges::none_of(moves, [&](const Move& other) {
+                return &other != &move && !other.constant && other.from == move.to;
+            });
+        });
+        if (ready != moves.end()) {
+            emit(*ready);
+            moves.erase(ready);
+            continue;
+        }
+        const MoveLocation blocked = moves.front().to;
+        emit(Move{temporary, blocked, std::nullopt});
+        for (Move& move : moves) {
+            if (!move.constant && move.from == blocked) {
+                move.from = temporary;
+            }
+        }
+    }
+}
+
+#endif //PARALLELCOPY_HPP
@@ -0,0 +1,260 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef PEEPHOLE_HPP
+#define PEEPHOLE_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+// Rewrites short sequences of emitted AArch64 instructions into cheaper
+// ones. Runs over the finished assembly lines; a window never spans a label
+// or directive, so every rule sees straight-line code. Rules are tried in
+// table order at each instruction, and after a rewrite the previous
+// instruction is looked at again, since the rewrite may have made a new
+// match with it. Each rule counts how often it fired.
+class Peephole {
+    public:
+    // One line of assembly; instructions are split into mnemonic and
+    // operands, everything else is kept as text.
+    struct Line {
+        std::string text;
+        std::string mnemonic;
+        std::vector<std::string> operands;
+
+        [[nodiscard]] bool isInstruction() const { return !mnemonic.empty(); }
+
+        static Line
+        Parse(const std::string& text) {
+            Line line{text, {}, {}};
+            if (text.size() < 2 || text[0] != '\t' || text[1] == '.') {
+                return line;
+            }
+            const std::size_t space = text.find(' ', 1);
+            line.mnemonic = text.substr(1, space == std::string::npos ? std::string::npos : space - 1);
+            if (space == std::string::npos) {
+                return line;
+            }
+            // Operands are separated by ", " except inside brackets.
+            std::string operand;
+            int depth = 0;
+            for (std::size_t i = space + 1; i < text.size(); ++i) {
+                const char c = text[i];
+                depth += c == '[' ? 1 : c == ']' ? -1 : 0;
+                if (c == ',' && depth == 0) {
+                    line.operands.push_back(std::move(operand));
+                    operand.clear();
+                    i += i + 1 < text.size() && text[i + 1] == ' ' ? 1 : 0;
+                    continue;
+                }
+                operand += c;
+            }
+            line.operands.push_back(std::move(operand));
+            return line;
+        }
+
+        static Line
+        Make(std::string_view mnemonic, std::vector<std::string> operands) {
+            std::string text = "\t" + std::string(mnemonic);
+            for (std::size_t i = 0; i < operands.size(); ++i) {
+                text += (i == 0 ? " " : ", ") + operands[i];
+            }
+            return {std::move(text), std::string(mnemonic), std::move(operands)};
+        }
+
+        // Whether any operand after the first names reg, inside an address
+        // or shift included. Only whole names count: x10 does not name x1.
+        [[nodiscard]] bool
+        readsAfterFirst(const std::string& reg) const {
+            const auto partOfName = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; };
+            for (std::size_t i = 1; i < operands.size(); ++i) {
+                const std::string& operand = operands[i];
+                for (std::size_t at = operand.find(reg); at != std::string::npos; at = operand.find(reg, at + 1)) {
+                    const std::size_t end = at + reg.size();
+                    if ((at == 0 || !partOfName(operand[at - 1])) && (end == operand.size() || !partOfName(operand[end]))) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+    };
+
+    using Rewrite = std::optional<std::vector<Line>> (*)(std::span<const Line>);
+
+    struct Rule {
+        std::string_view name;
+        std::size_t width;
+        Rewrite rewrite;
+        std::uint64_t hits = 0;
+    };
+
+    std::vector<Rule> rules = {
+        {"self-move", 1, SelfMove},
+        {"push-pop", 2, PushPop},
+        {"store-to-load", 2, StoreToLoad},
+        {"dead-move", 2, DeadMove},
+        {"multiply-add", 2, MultiplyAdd},
+        {"multiply-subtract", 2, MultiplySubtract},
+        {"shift-add", 2, ShiftAdd},
+    };
+
+    void
+    Run(std::vector<Line>& lines) {
+        std::size_t i = 0;
+        while (i < lines.size()) {
+            bool rewritten = false;
+            for (Rule& rule : rules) {
+                if (i + rule.width > lines.size()) {
+                    continue;
+                }
+                const std::span<const Line> window(lines.begin() + static_cast<std::ptrdiff_t>(i), rule.width);
+                if (!std::ranges::all_of(window, &Line::isInstruction)) {
+                    continue;
+                }
+                if (auto replacement = rule.rewrite(window)) {
+                    const auto at = lines.begin() + static_cast<std::ptrdiff_t>(i);
+                    lines.erase(at, at + static_cast<std::ptrdiff_t>(rule.width));
+                    lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(i), std::make_move_iterator(replacement->begin()),
+                                 std::make_move_iterator(replacement->end()));
+                    ++rule.hits;
+                    rewritten = true;
+                    break;
+                }
+            }
+            i = rewritten ? (i > 0 ? i - 1 : 0) : i + 1;
+        }
+    }
+
+    void
+    Report(std::ostream& out) const {
+        for (const Rule& rule : rules) {
+            out << std::format("Peephole rule {}: {} hits\n", rule.name, rule.hits);
+        }
+    }
+
+    private:
+    static bool
+    IsRegister(const std::string& operand) {
+        return operand.size() >= 2 && operand[0] == 'x' && std::isdigit(static_cast<unsigned char>(operand[1]));
+    }
+
+    // Instructions that only write their first operand, from the others.
+    static bool
+    DefinesFirst(const Line& line) {
+        static constexpr std::string_view defining[] = {"mov", "add", "sub", "mul", "sdiv", "neg", "madd", "msub", "ldr"};
+        return std::ranges::find(defining, line.mnemonic) != std::end(defining) && !line.operands.empty() &&
+               !line.operands.back().ends_with("!") && (line.mnemonic != "ldr" || line.operands.size() == 2);
+    }
+
+    // mov xA, xA
+    static std::optional<std::vector<Line>>
+    SelfMove(std::span<const Line> window) {
+        const Line& move = window[0];
+        if (move.mnemonic == "mov" && move.operands.size() == 2 && move.operands[0] == move.operands[1]) {
+            return std::vector<Line>{};
+        }
+        return std::nullopt;
+    }
+
+    // str xA, [sp, #-16]! ; ldr xB, [sp], #16  =>  mov xB, xA
+    static std::optional<std::vector<Line>>
+    PushPop(std::span<const Line> window) {
+        const Line& push = window[0];
+        const Line& pop = window[1];
+        if (push.mnemonic == "str" && push.operands.size() == 2 && push.operands[1] == "[sp, #-16]!" &&
+            pop.mnemonic == "ldr" && pop.operands.size() == 3 && pop.operands[1] == "[sp]" && pop.operands[2] == "#16") {
+            return std::vector{Line::Make("mov", {pop.operands[0], push.operands[0]})};
+        }
+        return std::nullopt;
+    }
+
+    // str xA, [addr] ; ldr xB, [addr]  =>  str xA, [addr] ; mov xB, xA
+    static std::optional<std::vector<Line>>
+    StoreToLoad(std::span<const Line> window) {
+        const Line& store = window[0];
+        const Line& load = window[1];
+        if (store.mnemonic == "str" && load.mnemonic == "ldr" && store.operands.size() == 2 && load.operands.size() == 2 &&
+            store.operands[1] == load.operands[1] && !store.operands[1].ends_with("!") && IsRegister(store.operands[0])) {
+            return std::vector{store, Line::Make("mov", {load.operands[0], store.operands[0]})};
+        }
+        return std::nullopt;
+    }
+
+    // mov xA, ... ; op xA, ... (not reading xA)  =>  op xA, ...
+    static std::optional<std::vector<Line>>
+    DeadMove(std::span<const Line> window) {
+        const Line& move = window[0];
+        const Line& next = window[1];
+        if (move.mnemonic == "mov" && move.operands.size() == 2 && DefinesFirst(next) &&
+            next.operands[0] == move.operands[0] && !next.readsAfterFirst(move.operands[0])) {
+            return std::vector{next};
+        }
+        return std::nullopt;
+    }
+
+    // mul xD, xN, xM ; add xD, xD, xA  =>  madd xD, xN, xM, xA
+    static std::optional<std::vector<Line>>
+    MultiplyAdd(std::span<const Line> window) {
+        const Line& multiply = window[0];
+        const Line& add = window[1];
+        if (multiply.mnemonic != "mul" || add.mnemonic != "add" || add.operands.size() != 3) {
+            return std::nullopt;
+        }
+        const std::string& product = multiply.operands[0];
+        if (add.operands[0] != product || (add.operands[1] == product) == (add.operands[2] == product)) {
+            return std::nullopt;
+        }
+        const std::string& addend = add.operands[1] == product ? add.operands[2] : add.operands[1];
+        if (!IsRegister(addend) && addend != "xzr") {
+            return std::nullopt;
+        }
+        return std::vector{Line::Make("madd", {product, multiply.operands[1], multiply.operands[2], addend})};
+    }
+
+    // mul xD, xN, xM ; sub xD, xA, xD  =>  msub xD, xN, xM, xA
+    static std::optional<std::vector<Line>>
+    MultiplySubtract(std::span<const Line> window) {
+        const Line& multiply = window[0];
+        const Line& sub = window[1];
+        if (multiply.mnemonic != "mul" || sub.mnemonic != "sub" || sub.operands.size() != 3) {
+            return std::nullopt;
+        }
+        const std::string& product = multiply.operands[0];
+        const std::string& minuend = sub.operands[1];
+        if (sub.operands[0] != product || sub.operands[2] != product || minuend == product ||
+            (!IsRegister(minuend) && minuend != "xzr")) {
+            return std::nullopt;
+        }
+        return std::vector{Line::Make("msub", {product, multiply.operands[1], multiply.operands[2], minuend})};
+    }
+
+    // lsl xD, xN, #k ; add xD, xD, xA  =>  add xD, xA, xN, lsl #k
+    static std::optional<std::vector<Line>>
+    ShiftAdd(std::span<const Line> window) {
+        const Line& shift = window[0];
+        const Line& add = window[1];
+        if (shift.mnemonic != "lsl" || add.mnemonic != "add" || shift.operands.size() != 3 || add.operands.size() != 3 ||
+            !shift.operands[2].starts_with("#")) {
+            return std::nullopt;
+        }
+        const std::string& shifted = shift.operands[0];
+        if (add.operands[0] != shifted || (add.operands[1] == shifted) == (add.operands[2] == shifted)) {
+            return std::nullopt;
+        }
+        const std::string& addend = add.operands[1] == shifted ? add.operands[2] : add.operands[1];
+        if (!IsRegister(addend)) {
+            return std::nullopt;
+        }
+        return std::vector{Line::Make("add", {shifted, addend, shift.operands[1], "lsl " + shift.operands[2]})};
+    }
+};
+
+#endif //PEEPHOLE_HPP
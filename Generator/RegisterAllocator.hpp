@@ -0,0 +1,231 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef REGISTERALLOCATOR_HPP
+#define REGISTERALLOCATOR_HPP
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <vector>
+#include "../IR/Liveness.hpp"
+
+// Where a virtual register lives for its whole lifetime.
+struct Location {
+    enum class Kind : std::uint8_t { None, Register, Stack };
+    Kind kind = Kind::None;
+    // Machine register number (xN), or spill slot index.
+    int index = 0;
+};
+
+// Span of instruction positions over which a value is live; see
+// RegisterAllocator::NumberBlocks.
+struct LiveRange {
+    std::uint32_t start;
+    std::uint32_t end;
+};
+
+// Registers a target lets the allocator hand out, each list in order of
+// preference.
+struct MachineRegisters {
+    std::span<const int> callerSaved;
+    std::span<const int> calleeSaved;
+};
+
+struct Allocation {
+    std::vector<Location> locations;
+    std::uint32_t spillSlots = 0;
+    // Where the value of each spill slot is live, so the frame layout can
+    // let slots that are never live at once share memory.
+    std::vector<LiveRange> spillRanges;
+    // Callee-saved registers that were handed out, ascending.
+    std::vector<int> calleeSaved;
+    std::uint32_t values = 0;
+};
+
+// Linear-scan register allocation (Poletto and Sarkar). Each virtual
+// register gets one live interval covering every point where it is live, in
+// a numbering of the instructions in block order. Intervals are taken by
+// start: values live across a call may only use callee-saved registers,
+// others prefer the caller-saved ones. When no register is free the interval
+// that ends last is spilled to its own frame slot.
+//
+// The default set is AAPCS64's: x0-x7 carry arguments and results, x8 and
+// x16/x17 are left to the code generator as scratch, x18 is reserved by the
+// platform and x29/x30 are the frame and link registers.
+class RegisterAllocator {
+    public:
+    static constexpr int CallerSaved[] = {9, 10, 11, 12, 13, 14, 15};
+    static constexpr int CalleeSaved[] = {19, 20, 21, 22, 23, 24, 25, 26, 27, 28};
+    static constexpr MachineRegisters AArch64 = {CallerSaved, CalleeSaved};
+
+    static Allocation
+    Allocate(const IRFunction& function, const MachineRegisters& registers = AArch64) {
+        const auto isCalleeSaved = [&](int reg) {
+            return std::ranges::find(registers.calleeSaved, reg) != registers.calleeSaved.end();
+        };
+        const std::vector<Interval> intervals = BuildIntervals(function);
+        std::vector<const Interval*> order;
+        for (const Interval& interval : intervals) {
+            if (interval.start <= interval.end) {
+                order.push_back(&interval);
+            }
+        }
+        std::ranges::sort(order, [](const Interval* a, const Interval* b) {
+            return a->start != b->start ? a->start < b->start : a->reg < b->reg;
+        });
+
+        Allocation allocation;
+        allocation.locations.resize(function.registers.size());
+        allocation.values = static_cast<std::uint32_t>(order.size());
+        std::vector<bool> used(32, false);
+        std::vector<bool> busy(32, false);
+        std::vector<const Interval*> active;
+        const auto spill = [&](const Interval* interval) {
+            allocation.locations[interval->reg] = {Location::Kind::Stack, static_cast<int>(allocation.spillSlots++)};
+            allocation.spillRanges.push_back({interval->start, interval->end});
+        };
+
+        for (const Interval* current : order) {
+            std::erase_if(active, [&](const Interval* interval) {
+                if (interval->end < current->start) {
+                    busy[allocation.locations[interval->reg].index] = false;
+                    return true;
+                }
+                return false;
+            });
+
+            int chosen = -1;
+            if (!current->crossesCall) {
+                chosen = FirstFree(registers.callerSaved, busy);
+            }
+            if (chosen < 0) {
+                chosen = FirstFree(registers.calleeSaved, busy);
+            }
+            if (chosen < 0) {
+                // Take the register of the active interval that ends last, if
+                // it ends after this one and its register suits this one.
+                const Interval* victim = nullptr;
+                for (const Interval* interval : active) {
+                    const int reg = allocation.locations[interval->reg].index;
+                    if ((!current->crossesCall || isCalleeSaved(reg)) && (!victim || interval->end > victim->end)) {
+                        victim = interval;
+                    }
+                }
+                if (!victim || victim->end <= current->end) {
+                    spill(current);
+                    continue;
+                }
+                chosen = allocation.locations[victim->reg].index;
+                spill(victim);
+                std::erase(active, victim);
+            }
+            busy[chosen] = true;
+            used[chosen] = true;
+            allocation.locations[current->reg] = {Location::Kind::Register, chosen};
+            active.push_back(current);
+        }
+
+        for (const int reg : registers.calleeSaved) {
+            if (used[reg]) {
+                allocation.calleeSaved.push_back(reg);
+            }
+        }
+        return allocation;
+    }
+
+    // Instruction k is numbered 2k where it reads its operands and 2k+1
+    // where it writes its result, so a value may reuse the register of an
+    // operand that dies at the same instruction. A block spans from its first
+    // instruction's number to just past its terminator's, where phi copies
+    // for the successor happen.
+    static void
+    NumberBlocks(const IRFunction& function, std::vector<std::uint32_t>& blockStart, std::vector<std::uint32_t>& blockEnd) {
+        blockStart.assign(function.blocks.size(), 0);
+        blockEnd.assign(function.blocks.size(), 0);
+        std::uint32_t index = 0;
+        for (const BasicBlock& block : function.blocks) {
+            blockStart[block.id] = 2 * index;
+            index += static_cast<std::uint32_t>(block.instructions.size());
+            blockEnd[block.id] = 2 * index - 1;
+        }
+    }
+
+    private:
+    struct Interval {
+        VReg reg;
+        std::uint32_t start = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t end = 0;
+        bool crossesCall = false;
+
+        void
+        Cover(std::uint32_t position) {
+            start = std::min(start, position);
+            end = std::max(end, position);
+        }
+    };
+
+    static int
+    FirstFree(std::span<const int> registers, const std::vector<bool>& busy) {
+        for (const int reg : registers) {
+            if (!busy[reg]) {
+                return reg;
+            }
+        }
+        return -1;
+    }
+
+    static std::vector<Interval>
+    BuildIntervals(const IRFunction& function) {
+        std::vector<Interval> intervals(function.registers.size());
+        for (VReg reg = 0; reg < intervals.size(); ++reg) {
+            intervals[reg].reg = reg;
+        }
+        const Liveness liveness(function);
+        std::vector<std::uint32_t> blockStart;
+        std::vector<std::uint32_t> blockEnd;
+        NumberBlocks(function, blockStart, blockEnd);
+
+        std::vector<std::uint32_t> calls;
+        std::uint32_t index = 0;
+        for (const BasicBlock& block : function.blocks) {
+            liveness.liveIn[block.id].ForEach([&](VReg reg) { intervals[reg].Cover(blockStart[block.id]); });
+            liveness.liveOut[block.id].ForEach([&](VReg reg) { intervals[reg].Cover(blockEnd[block.id]); });
+            for (const Instruction& instruction : block.instructions) {
+                const std::uint32_t position = 2 * index++;
+                if (instruction.op == Opcode::Phi) {
+                    intervals[instruction.result].Cover(blockStart[block.id]);
+                    // The predecessors write the phi's register as they leave.
+                    for (std::size_t i = 0; i < instruction.blocks.size(); ++i) {
+                        intervals[instruction.result].Cover(blockEnd[instruction.blocks[i]]);
+                        if (instruction.operands[i].isReg()) {
+                            intervals[instruction.operands[i].reg].Cover(blockEnd[instruction.blocks[i]]);
+                        }
+                    }
+                    continue;
+                }
+                for (const Operand& operand : instruction.operands) {
+                    if (operand.isReg()) {
+                        intervals[operand.reg].Cover(position);
+                    }
+                }
+                if (instruction.result != NoVReg) {
+                    intervals[instruction.result].Cover(position + 1);
+                }
+                if (instruction.op == Opcode::Call) {
+                    calls.push_back(position);
+                }
+            }
+        }
+
+        for (Interval& interval : intervals) {
+            // A parameter is live from position 0, where a call may read it.
+            const auto call = std::ranges::lower_bound(calls, interval.start);
+            interval.crossesCall = call != calls.end() && *call + 1 < interval.end;
+        }
+        return intervals;
+    }
+};
+
+#endif //REGISTERALLOCATOR_HPP
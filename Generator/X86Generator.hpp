@@ -0,0 +1,668 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef X86GENERATOR_HPP
+#define X86GENERATOR_HPP
+
+#include <format>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "../Optimizer/Pipeline.hpp"
+#include "../Optimizer/TailRecursion.hpp"
+#include "CompilerOptions.hpp"
+#include "FrameLayout.hpp"
+#include "ParallelCopy.hpp"
+#include "RegisterAllocator.hpp"
+
+// x86-64 backend for Linux, emitting GAS (AT&T syntax) for an ELF
+// assembler. Consumes the same verified IR as the AArch64 Generator and
+// lays out frames the same way, below rbp.
+//
+// Calls follow the System V ABI: the first six arguments go in rdi, rsi,
+// rdx, rcx, r8 and r9 and the rest are pushed, first lowest; the result
+// comes back in rax. Values may live in rdi, rsi, r8 and r9 between calls,
+// so arguments, parameters and phis are all moved as parallel copies. rax,
+// rdx and rcx are kept free for idiv, the high half of imul and shift
+// counts; r10 and r11 hold spilled or constant operands.
+//
+// Operands that live in the frame are used as memory operands instead of
+// being loaded first, small multiplications and three-operand additions are
+// done with lea, and idiv is only emitted for a division the strength
+// reduction pass left, by a divisor other than 1 or -1.
+//
+// Programs run without a C runtime: main exits through the exit system
+// call, and the unit that defines it also defines _start, the entry point
+// ld looks for, which calls main so the stack is aligned as after a call.
+class X86Generator {
+    public:
+    static std::string
+    GenerateAssembly(const IRModule& module, const CompilerOptions& options = {}) {
+        X86Generator generator;
+        generator.tailCalls = Pipeline::Runs(options, "tail-calls");
+        generator.EmitLine("\t.text");
+        for (const IRFunction& function : module.functions) {
+            generator.GenerateFunction(function);
+            if (options.reportSpills) {
+                generator.ReportAllocation();
+            }
+        }
+        generator.EmitLine("\t.section .note.GNU-stack,\"\",@progbits");
+        return std::move(generator.assembly);
+    }
+
+    private:
+    // Hardware register numbers.
+    static constexpr int Rax = 0, Rcx = 1, Rdx = 2, Rbx = 3, Rsp = 4, Rbp = 5, Rsi = 6, Rdi = 7;
+    static constexpr int R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15;
+    static constexpr int ArgumentRegisters[] = {Rdi, Rsi, Rdx, Rcx, R8, R9};
+    static constexpr int CallerSaved[] = {Rdi, Rsi, R8, R9};
+    static constexpr int CalleeSaved[] = {Rbx, R12, R13, R14, R15};
+    static constexpr MachineRegisters Registers = {CallerSaved, CalleeSaved};
+
+    std::string assembly;
+    bool tailCalls = false;
+    const IRFunction* function = nullptr;
+    std::string functionName;
+    Allocation allocation;
+    std::vector<int> slotOffsets;
+    std::vector<int> spillOffsets;
+
+    void
+    EmitLine(const std::string& line) {
+        assembly += line;
+        assembly += '\n';
+    }
+
+    static std::string
+    RegisterName(int reg) {
+        static constexpr std::string_view names[] = {"%rax", "%rcx", "%rdx", "%rbx", "%rsp", "%rbp", "%rsi", "%rdi",
+                                                     "%r8",  "%r9",  "%r10", "%r11", "%r12", "%r13", "%r14", "%r15"};
+        return std::string(names[reg]);
+    }
+
+    // The low 32 bits of reg; writing them clears the upper half.
+    static std::string
+    Register32(int reg) {
+        static constexpr std::string_view names[] = {"%eax", "%ecx", "%edx",  "%ebx",  "%esp",  "%ebp",  "%esi",  "%edi",
+                                                     "%r8d", "%r9d", "%r10d", "%r11d", "%r12d", "%r13d", "%r14d", "%r15d"};
+        return std::string(names[reg]);
+    }
+
+    static std::string
+    Memory(int offset) {
+        return std::to_string(offset) + "(%rbp)";
+    }
+
+    static bool
+    FitsImmediate(std::int64_t value) {
+        return value >= std::numeric_limits<std::int32_t>::min() && value <= std::numeric_limits<std::int32_t>::max();
+    }
+
+    std::string
+    Label(BlockId block) const {
+        return ".L" + functionName + "_" + std::to_string(block);
+    }
+
+    void
+    ReportAllocation() const {
+        std::uint32_t spilled = 0;
+        for (const Location& location : allocation.locations) {
+            spilled += location.kind == Location::Kind::Stack;
+        }
+        std::string saved;
+        for (const int reg : allocation.calleeSaved) {
+            saved += " " + RegisterName(reg);
+        }
+        std::cout << std::format("Register allocation for {}: {} values, {} spilled, callee-saved:{}\n",
+                                 functionName, allocation.values, spilled, saved.empty() ? " none" : saved);
+    }
+
+    // Zero is xor, and a constant that fits 32 unsigned bits a 32-bit move,
+    // both shorter than the 64-bit forms.
+    void
+    MoveImmediate(int reg, std::int64_t value) {
+        if (value == 0) {
+            EmitLine("\txorl " + Register32(reg) + ", " + Register32(reg));
+        } else if (value > 0 && value <= std::numeric_limits<std::uint32_t>::max()) {
+            EmitLine("\tmovl $" + std::to_string(value) + ", " + Register32(reg));
+        } else if (FitsImmediate(value)) {
+            EmitLine("\tmovq $" + std::to_string(value) + ", " + RegisterName(reg));
+        } else {
+            EmitLine("\tmovabsq $" + std::to_string(value) + ", " + RegisterName(reg));
+        }
+    }
+
+    // Where a register operand lives: its machine register or its frame
+    // slot, usable as an operand of most instructions either way.
+    std::string
+    Place(VReg reg) const {
+        const Location& location = allocation.locations[reg];
+        if (location.kind == Location::Kind::Register) {
+            return RegisterName(location.index);
+        }
+        return Memory(spillOffsets[location.index]);
+    }
+
+    bool
+    InRegister(const Operand& operand) const {
+        return operand.isReg() && allocation.locations[operand.reg].kind == Location::Kind::Register;
+    }
+
+    // operand as a source operand: an immediate when it fits, else loaded
+    // into scratch.
+    std::string
+    Use(const Operand& operand, int scratch) {
+        if (operand.isReg()) {
+            return Place(operand.reg);
+        }
+        if (FitsImmediate(operand.imm)) {
+            return "$" + std::to_string(operand.imm);
+        }
+        MoveImmediate(scratch, operand.imm);
+        return RegisterName(scratch);
+    }
+
+    // Register to write result to; Commit stores it if it was spilled.
+    std::string
+    Def(VReg result) const {
+        const Location& location = allocation.locations[result];
+        return location.kind == Location::Kind::Register ? RegisterName(location.index) : RegisterName(R10);
+    }
+
+    void
+    Commit(VReg result) {
+        const Location& location = allocation.locations[result];
+        if (location.kind == Location::Kind::Stack) {
+            EmitLine("\tmovq %r10, " + Memory(spillOffsets[location.index]));
+        }
+    }
+
+    // Copies operand into the register named to, unless it is already there.
+    void
+    MoveInto(const std::string& to, const Operand& operand) {
+        if (operand.isImm()) {
+            MoveImmediate(RegisterNumber(to), operand.imm);
+        } else if (Place(operand.reg) != to) {
+            EmitLine("\tmovq " + Place(operand.reg) + ", " + to);
+        }
+    }
+
+    static int
+    RegisterNumber(const std::string& name) {
+        for (int reg = 0; reg < 16; ++reg) {
+            if (RegisterName(reg) == name) {
+                return reg;
+            }
+        }
+        throw std::runtime_error("No x86-64 register " + name);
+    }
+
+    void
+    GenerateFunction(const IRFunction& irFunction) {
+        function = &irFunction;
+        functionName = std::string(Interner::spelling(function->name));
+        allocation = RegisterAllocator::Allocate(irFunction, Registers);
+        FrameLayout frame(irFunction, allocation);
+        slotOffsets = std::move(frame.slotOffsets);
+        spillOffsets = std::move(frame.spillOffsets);
+
+        if (functionName == "main") {
+            EmitLine("\t.globl _start");
+            EmitLine("_start:");
+            EmitLine("\tcall main");
+        }
+        // Every function is exported so other units can import and call it.
+        EmitLine("\t.globl " + functionName);
+        EmitLine("\t.type " + functionName + ", @function");
+        EmitLine(functionName + ":");
+
+        EmitLine("\tpushq %rbp");
+        EmitLine("\tmovq %rsp, %rbp");
+        if (frame.size > 0) {
+            EmitLine("\tsubq $" + std::to_string(frame.size) + ", %rsp");
+        }
+        // Callee-saved registers go at the top of the frame, 8 bytes each.
+        for (std::size_t i = 0; i < allocation.calleeSaved.size(); ++i) {
+            EmitLine("\tmovq " + RegisterName(allocation.calleeSaved[i]) + ", " + Memory(-8 * static_cast<int>(i + 1)));
+        }
+        MoveParameters();
+
+        for (const BasicBlock& block : function->blocks) {
+            if (block.id != 0) {
+                EmitLine(Label(block.id) + ":");
+            }
+            for (std::size_t i = 0; i < block.instructions.size(); ++i) {
+                if (IsTailCall(block, i)) {
+                    GenerateTailCall(block.instructions[i]);
+                    ++i;
+                    continue;
+                }
+                GenerateInstruction(block, block.instructions[i]);
+            }
+        }
+        EmitLine("\t.size " + functionName + ", .-" + functionName);
+    }
+
+    MoveLocation
+    LocationOf(VReg reg) const {
+        const Location& location = allocation.locations[reg];
+        if (location.kind == Location::Kind::Register) {
+            return {location.index, 0};
+        }
+        return {-1, spillOffsets[location.index]};
+    }
+
+    // Moves each parameter that is used from where the caller passed it.
+    // Parameters may have been given each other's argument registers.
+    void
+    MoveParameters() {
+        std::vector<Move> moves;
+        for (std::size_t i = 0; i < function->parameters.size(); ++i) {
+            const VReg parameter = function->parameters[i];
+            if (allocation.locations[parameter].kind == Location::Kind::None) {
+                continue;
+            }
+            const MoveLocation from = i < std::size(ArgumentRegisters)
+                                          ? MoveLocation{ArgumentRegisters[i], 0}
+                                          : MoveLocation{-1, 16 + 8 * static_cast<int>(i - std::size(ArgumentRegisters))};
+            if (from != LocationOf(parameter)) {
+                moves.push_back({LocationOf(parameter), from, std::nullopt});
+            }
+        }
+        ScheduleMoves(std::move(moves), {R10, 0}, [&](const Move& move) { EmitMove(move); });
+    }
+
+    void
+    EmitMove(const Move& move) {
+        const std::string from = move.from.reg >= 0 ? RegisterName(move.from.reg) : Memory(move.from.offset);
+        if (move.to.reg >= 0) {
+            if (move.constant) {
+                MoveImmediate(move.to.reg, *move.constant);
+            } else {
+                EmitLine("\tmovq " + from + ", " + RegisterName(move.to.reg));
+            }
+            return;
+        }
+        const std::string to = Memory(move.to.offset);
+        if (move.constant && FitsImmediate(*move.constant)) {
+            EmitLine("\tmovq $" + std::to_string(*move.constant) + ", " + to);
+        } else if (move.constant) {
+            MoveImmediate(R11, *move.constant);
+            EmitLine("\tmovq %r11, " + to);
+        } else if (move.from.reg >= 0) {
+            EmitLine("\tmovq " + from + ", " + to);
+        } else {
+            EmitLine("\tmovq " + from + ", %r11");
+            EmitLine("\tmovq %r11, " + to);
+        }
+    }
+
+    // Restores the caller's registers and frame, leaving the return address
+    // on top of the stack.
+    void
+    GenerateEpilogue() {
+        for (std::size_t i = 0; i < allocation.calleeSaved.size(); ++i) {
+            EmitLine("\tmovq " + Memory(-8 * static_cast<int>(i + 1)) + ", " + RegisterName(allocation.calleeSaved[i]));
+        }
+        EmitLine("\tleave");
+    }
+
+    // As on AArch64: calls from functions other than main whose arguments
+    // all go in registers reuse the frame, when "tail-calls" runs.
+    bool
+    IsTailCall(const BasicBlock& block, std::size_t index) const {
+        return tailCalls && functionName != "main" && TailRecursion::IsTailCall(block, index) &&
+               block.instructions[index].operands.size() <= std::size(ArgumentRegisters);
+    }
+
+    void
+    GenerateTailCall(const Instruction& call) {
+        MoveArguments(call);
+        GenerateEpilogue();
+        EmitLine("\tjmp " + std::string(Interner::spelling(call.callee)));
+    }
+
+    void
+    GenerateInstruction(const BasicBlock& block, const Instruction& instruction) {
+        switch (instruction.op) {
+            case Opcode::Add:
+                GenerateAdd(instruction);
+                break;
+            case Opcode::Sub:
+                GenerateSubtract(instruction);
+                break;
+            case Opcode::Mul:
+                GenerateMultiply(instruction);
+                break;
+            case Opcode::SDiv:
+                GenerateDivide(instruction);
+                break;
+            case Opcode::MulHi:
+                GenerateMultiplyHigh(instruction);
+                break;
+            case Opcode::Shl:
+            case Opcode::AShr:
+            case Opcode::LShr:
+                GenerateShift(instruction);
+                break;
+            case Opcode::Neg: {
+                const std::string result = Def(instruction.result);
+                MoveInto(result, instruction.operands[0]);
+                EmitLine("\tnegq " + result);
+                Commit(instruction.result);
+                break;
+            }
+            case Opcode::Copy:
+                GenerateCopy(instruction);
+                break;
+            case Opcode::Load: {
+                const std::string result = Def(instruction.result);
+                EmitLine("\tmovq " + Memory(slotOffsets[instruction.slot]) + ", " + result);
+                Commit(instruction.result);
+                break;
+            }
+            case Opcode::Store: {
+                const Operand& value = instruction.operands[0];
+                std::string source = Use(value, R11);
+                if (!value.isImm() && !InRegister(value)) {
+                    EmitLine("\tmovq " + source + ", %r11");
+                    source = "%r11";
+                }
+                EmitLine("\tmovq " + source + ", " + Memory(slotOffsets[instruction.slot]));
+                break;
+            }
+            case Opcode::Call:
+                GenerateCall(instruction);
+                break;
+            case Opcode::Phi:
+                // Written by the predecessors' branches.
+                break;
+            case Opcode::Br:
+                CopyPhiOperands(block.id, instruction.blocks[0]);
+                if (instruction.blocks[0] != block.id + 1) {
+                    EmitLine("\tjmp " + Label(instruction.blocks[0]));
+                }
+                break;
+            case Opcode::Ret:
+                MoveInto("%rax", instruction.operands[0]);
+                GenerateEpilogue();
+                if (functionName == "main") {
+                    EmitLine("\tmovq %rax, %rdi");
+                    EmitLine("\tmovl $60, %eax");
+                    EmitLine("\tsyscall");
+                } else {
+                    EmitLine("\tret");
+                }
+                break;
+        }
+    }
+
+    // result = lhs op rhs in two-address form: lhs is moved into the result
+    // register and rhs applied to it, from memory or as an immediate if that
+    // is where it is. When rhs already occupies the result register a
+    // commutative operation swaps its operands instead.
+    void
+    GenerateTwoAddress(std::string_view mnemonic, Operand lhs, Operand rhs, VReg resultReg, bool commutative) {
+        const std::string result = Def(resultReg);
+        if (rhs.isReg() && Place(rhs.reg) == result && !(lhs.isReg() && Place(lhs.reg) == result)) {
+            if (commutative) {
+                std::swap(lhs, rhs);
+            } else {
+                // result = lhs - result
+                EmitLine("\tnegq " + result);
+                EmitLine("\taddq " + Use(lhs, R11) + ", " + result);
+                Commit(resultReg);
+                return;
+            }
+        }
+        MoveInto(result, lhs);
+        EmitLine("\t" + std::string(mnemonic) + " " + Use(rhs, R11) + ", " + result);
+        Commit(resultReg);
+    }
+
+    // lea adds two registers, or a register and a constant, into a third
+    // without first copying one of them.
+    void
+    GenerateAdd(const Instruction& instruction) {
+        Operand lhs = instruction.operands[0];
+        Operand rhs = instruction.operands[1];
+        if (lhs.isImm()) {
+            std::swap(lhs, rhs);
+        }
+        const std::string result = Def(instruction.result);
+        const bool distinct = InRegister(lhs) && Place(lhs.reg) != result;
+        if (distinct && rhs.isImm() && FitsImmediate(rhs.imm)) {
+            EmitLine("\tleaq " + std::to_string(rhs.imm) + "(" + Place(lhs.reg) + "), " + result);
+            Commit(instruction.result);
+        } else if (distinct && InRegister(rhs) && Place(rhs.reg) != result) {
+            EmitLine("\tleaq (" + Place(lhs.reg) + "," + Place(rhs.reg) + "), " + result);
+            Commit(instruction.result);
+        } else {
+            GenerateTwoAddress("addq", lhs, rhs, instruction.result, true);
+        }
+    }
+
+    void
+    GenerateSubtract(const Instruction& instruction) {
+        const Operand& lhs = instruction.operands[0];
+        const Operand& rhs = instruction.operands[1];
+        const std::string result = Def(instruction.result);
+        if (lhs.isImm() && lhs.imm == 0) {
+            MoveInto(result, rhs);
+            EmitLine("\tnegq " + result);
+            Commit(instruction.result);
+        } else if (InRegister(lhs) && Place(lhs.reg) != result && rhs.isImm() &&
+                   rhs.imm != std::numeric_limits<std::int64_t>::min() && FitsImmediate(-rhs.imm)) {
+            EmitLine("\tleaq " + std::to_string(-rhs.imm) + "(" + Place(lhs.reg) + "), " + result);
+            Commit(instruction.result);
+        } else {
+            GenerateTwoAddress("subq", lhs, rhs, instruction.result, false);
+        }
+    }
+
+    // By 2, 4 or 8, and by 3, 5 or 9, lea scales an index register; other
+    // constants use the three-operand imul, which reads its source from a
+    // register or memory.
+    void
+    GenerateMultiply(const Instruction& instruction) {
+        Operand lhs = instruction.operands[0];
+        Operand rhs = instruction.operands[1];
+        if (lhs.isImm()) {
+            std::swap(lhs, rhs);
+        }
+        const std::string result = Def(instruction.result);
+        if (rhs.isImm() && InRegister(lhs)) {
+            const std::string source = Place(lhs.reg);
+            const std::int64_t factor = rhs.imm;
+            if (factor == 3 || factor == 5 || factor == 9) {
+                EmitLine("\tleaq (" + source + "," + source + "," + std::to_string(factor - 1) + "), " + result);
+                Commit(instruction.result);
+                return;
+            }
+            if (factor == 2) {
+                EmitLine("\tleaq (" + source + "," + source + "), " + result);
+                Commit(instruction.result);
+                return;
+            }
+            if (factor == 4 || factor == 8) {
+                EmitLine("\tleaq (," + source + "," + std::to_string(factor) + "), " + result);
+                Commit(instruction.result);
+                return;
+            }
+        }
+        if (rhs.isImm() && FitsImmediate(rhs.imm) && lhs.isReg()) {
+            EmitLine("\timulq $" + std::to_string(rhs.imm) + ", " + Place(lhs.reg) + ", " + result);
+            Commit(instruction.result);
+            return;
+        }
+        GenerateTwoAddress("imulq", lhs, rhs, instruction.result, true);
+    }
+
+    // The one-operand imul multiplies by rax into rdx:rax.
+    void
+    GenerateMultiplyHigh(const Instruction& instruction) {
+        Operand lhs = instruction.operands[0];
+        Operand rhs = instruction.operands[1];
+        if (rhs.isImm()) {
+            std::swap(lhs, rhs);
+        }
+        MoveInto("%rax", lhs);
+        if (rhs.isImm()) {
+            MoveImmediate(R11, rhs.imm);
+            EmitLine("\timulq %r11");
+        } else {
+            EmitLine("\timulq " + Place(rhs.reg));
+        }
+        EmitLine("\tmovq %rdx, " + Def(instruction.result));
+        Commit(instruction.result);
+    }
+
+    // idiv divides rdx:rax, sign-extended from rax by cqto, leaving the
+    // quotient in rax. Dividing by 1 or -1 needs no division.
+    void
+    GenerateDivide(const Instruction& instruction) {
+        const Operand& dividend = instruction.operands[0];
+        const Operand& divisor = instruction.operands[1];
+        const std::string result = Def(instruction.result);
+        if (divisor.isImm() && (divisor.imm == 1 || divisor.imm == -1)) {
+            MoveInto(result, dividend);
+            if (divisor.imm == -1) {
+                EmitLine("\tnegq " + result);
+            }
+            Commit(instruction.result);
+            return;
+        }
+        MoveInto("%rax", dividend);
+        EmitLine("\tcqto");
+        if (divisor.isImm()) {
+            MoveImmediate(R11, divisor.imm);
+            EmitLine("\tidivq %r11");
+        } else {
+            EmitLine("\tidivq " + Place(divisor.reg));
+        }
+        EmitLine("\tmovq %rax, " + result);
+        Commit(instruction.result);
+    }
+
+    // A variable count goes in cl. A left shift by one is an add of the
+    // register to itself, done by lea when the result goes elsewhere.
+    void
+    GenerateShift(const Instruction& instruction) {
+        const std::string mnemonic = instruction.op == Opcode::Shl ? "shlq" : instruction.op == Opcode::AShr ? "sarq" : "shrq";
+        const Operand& value = instruction.operands[0];
+        const Operand& count = instruction.operands[1];
+        const std::string result = Def(instruction.result);
+        if (count.isImm()) {
+            const std::int64_t amount = count.imm & 63;
+            if (instruction.op == Opcode::Shl && amount == 1 && InRegister(value)) {
+                EmitLine("\tleaq (" + Place(value.reg) + "," + Place(value.reg) + "), " + result);
+            } else {
+                MoveInto(result, value);
+                if (amount != 0) {
+                    EmitLine("\t" + mnemonic + " $" + std::to_string(amount) + ", " + result);
+                }
+            }
+            Commit(instruction.result);
+            return;
+        }
+        MoveInto("%rcx", count);
+        MoveInto(result, value);
+        EmitLine("\t" + mnemonic + " %cl, " + result);
+        Commit(instruction.result);
+    }
+
+    void
+    GenerateCopy(const Instruction& instruction) {
+        const Operand& value = instruction.operands[0];
+        const Location& location = allocation.locations[instruction.result];
+        if (location.kind == Location::Kind::Stack && value.isImm() && FitsImmediate(value.imm)) {
+            EmitLine("\tmovq $" + std::to_string(value.imm) + ", " + Memory(spillOffsets[location.index]));
+            return;
+        }
+        if (location.kind == Location::Kind::Stack && InRegister(value)) {
+            EmitLine("\tmovq " + Place(value.reg) + ", " + Memory(spillOffsets[location.index]));
+            return;
+        }
+        MoveInto(Def(instruction.result), value);
+        Commit(instruction.result);
+    }
+
+    // Loads the register arguments of call into rdi-r9, as one parallel
+    // copy since the values may be in argument registers themselves.
+    void
+    MoveArguments(const Instruction& call) {
+        std::vector<Move> moves;
+        for (std::size_t i = 0; i < std::min(call.operands.size(), std::size(ArgumentRegisters)); ++i) {
+            const Operand& argument = call.operands[i];
+            Move move{{ArgumentRegisters[i], 0}, {}, std::nullopt};
+            if (argument.isImm()) {
+                move.constant = argument.imm;
+            } else {
+                move.from = LocationOf(argument.reg);
+                if (move.from == move.to) {
+                    continue;
+                }
+            }
+            moves.push_back(move);
+        }
+        ScheduleMoves(std::move(moves), {R10, 0}, [&](const Move& move) { EmitMove(move); });
+    }
+
+    // Arguments past the sixth are pushed, last first, below 8 bytes of
+    // padding when their number is odd, so the stack stays 16-byte aligned
+    // at the call; they are popped after it.
+    void
+    GenerateCall(const Instruction& call) {
+        const std::size_t registers = std::size(ArgumentRegisters);
+        const std::size_t stacked = call.operands.size() > registers ? call.operands.size() - registers : 0;
+        const std::size_t area = (8 * stacked + 15) & ~std::size_t{15};
+        if (stacked % 2 != 0) {
+            EmitLine("\tsubq $8, %rsp");
+        }
+        for (std::size_t i = stacked; i-- > 0;) {
+            EmitLine("\tpushq " + Use(call.operands[registers + i], R11));
+        }
+        MoveArguments(call);
+        EmitLine("\tcall " + std::string(Interner::spelling(call.callee)));
+        if (area != 0) {
+            EmitLine("\taddq $" + std::to_string(area) + ", %rsp");
+        }
+        if (allocation.locations[call.result].kind != Location::Kind::None) {
+            EmitLine("\tmovq %rax, " + Place(call.result));
+        }
+    }
+
+    // Moves the values the phis of target take when entered from block, as
+    // one parallel copy; cycles are broken through r10.
+    void
+    CopyPhiOperands(BlockId block, BlockId target) {
+        std::vector<Move> moves;
+        for (const Instruction& phi : function->blocks[target].instructions) {
+            if (phi.op != Opcode::Phi) {
+                break;
+            }
+            for (std::size_t i = 0; i < phi.blocks.size(); ++i) {
+                if (phi.blocks[i] != block) {
+                    continue;
+                }
+                const Operand& value = phi.operands[i];
+                Move move{LocationOf(phi.result), {}, std::nullopt};
+                if (value.isImm()) {
+                    move.constant = value.imm;
+                } else {
+                    move.from = LocationOf(value.reg);
+                    if (move.from == move.to) {
+                        continue;
+                    }
+                }
+                moves.push_back(move);
+            }
+        }
+        ScheduleMoves(std::move(moves), {R10, 0}, [&](const Move& move) { EmitMove(move); });
+    }
+};
+
+#endif //X86GENERATOR_HPP
@@ -0,0 +1,164 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef CALLGRAPH_HPP
+#define CALLGRAPH_HPP
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "IR.hpp"
+
+// Which functions of a module call which. Calls to functions the module does
+// not define (imported ones) are external. Strongly connected components are
+// found with Tarjan's algorithm, iteratively, and listed bottom-up: every
+// component comes after the components it calls into.
+class CallGraph {
+    public:
+    explicit CallGraph(const IRModule& module)
+        : callees(module.functions.size()), callsExternal(module.functions.size(), false),
+          recursive(module.functions.size(), false) {
+        for (std::size_t i = 0; i < module.functions.size(); ++i) {
+            index.emplace(module.functions[i].name, i);
+        }
+        for (std::size_t i = 0; i < module.functions.size(); ++i) {
+            for (const BasicBlock& block : module.functions[i].blocks) {
+                for (const Instruction& instruction : block.instructions) {
+                    if (instruction.op != Opcode::Call) {
+                        continue;
+                    }
+                    if (const auto callee = Find(instruction.callee)) {
+                        if (std::ranges::find(callees[i], *callee) == callees[i].end()) {
+                            callees[i].push_back(*callee);
+                        }
+                    } else {
+                        callsExternal[i] = true;
+                    }
+                }
+            }
+        }
+        FindComponents();
+    }
+
+    [[nodiscard]] std::optional<std::size_t>
+    Find(SymbolId name) const {
+        const auto found = index.find(name);
+        return found == index.end() ? std::nullopt : std::optional(found->second);
+    }
+
+    [[nodiscard]] const std::vector<std::size_t>& Callees(std::size_t function) const { return callees[function]; }
+    [[nodiscard]] bool CallsExternal(std::size_t function) const { return callsExternal[function]; }
+    // Whether the function can reach a call to itself.
+    [[nodiscard]] bool IsRecursive(std::size_t function) const { return recursive[function]; }
+    [[nodiscard]] const std::vector<std::vector<std::size_t>>& BottomUp() const { return components; }
+
+    // Functions reachable through calls from root, root included.
+    [[nodiscard]] std::vector<bool>
+    ReachableFrom(std::size_t root) const {
+        std::vector<bool> reached(callees.size(), false);
+        std::vector<std::size_t> work = {root};
+        reached[root] = true;
+        while (!work.empty()) {
+            const std::size_t function = work.back();
+            work.pop_back();
+            for (const std::size_t callee : callees[function]) {
+                if (!reached[callee]) {
+                    reached[callee] = true;
+                    work.push_back(callee);
+                }
+            }
+        }
+        return reached;
+    }
+
+    private:
+    std::unordered_map<SymbolId, std::size_t> index;
+    std::vector<std::vector<std::size_t>> callees;
+    std::vector<bool> callsExternal;
+    std::vector<bool> recursive;
+    std::vector<std::vector<std::size_t>> components;
+
+    void
+    FindComponents() {
+        constexpr std::size_t Unvisited = static_cast<std::size_t>(-1);
+        const std::size_t count = callees.size();
+        std::vector<std::size_t> order(count, Unvisited);
+        std::vector<std::size_t> low(count, 0);
+        std::vector<bool> onStack(count, false);
+        std::vector<std::size_t> stack;
+        std::size_t counter = 0;
+        // (function, next callee) pairs standing in for recursion.
+        std::vector<std::pair<std::size_t, std::size_t>> frames;
+        for (std::size_t root = 0; root < count; ++root) {
+            if (order[root] != Unvisited) {
+                continue;
+            }
+            frames.emplace_back(root, 0);
+            while (!frames.empty()) {
+                auto& [function, next] = frames.back();
+                if (next == 0 && order[function] == Unvisited) {
+                    order[function] = low[function] = counter++;
+                    stack.push_back(function);
+                    onStack[function] = true;
+                }
+                if (next < callees[function].size()) {
+                    const std::size_t callee = callees[function][next++];
+                    if (order[callee] == Unvisited) {
+                        frames.emplace_back(callee, 0);
+                    } else if (onStack[callee]) {
+                        low[function] = std::min(low[function], order[callee]);
+                    }
+                    continue;
+                }
+                const std::size_t done = function;
+                frames.pop_back();
+                if (!frames.empty()) {
+                    low[frames.back().first] = std::min(low[frames.back().first], low[done]);
+                }
+                if (low[done] != order[done]) {
+                    continue;
+                }
+                std::vector<std::size_t> component;
+                std::size_t member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = false;
+                    component.push_back(member);
+                } while (member != done);
+                for (const std::size_t function : component) {
+                    recursive[function] = component.size() > 1 ||
+                                          std::ranges::find(callees[function], function) != callees[function].end();
+                }
+                components.push_back(std::move(component));
+            }
+        }
+    }
+};
+
+// When the module defines main, removes the functions main cannot reach and
+// returns whether there were any. Modules without main are libraries whose
+// functions may be called from other units, and are left alone.
+inline bool
+RemoveUnreachableFunctions(IRModule& module) {
+    const auto main = std::ranges::find_if(module.functions, [](const IRFunction& function) {
+        return Interner::spelling(function.name) == "main";
+    });
+    if (main == module.functions.end()) {
+        return false;
+    }
+    const std::vector<bool> reached = CallGraph(module).ReachableFrom(static_cast<std::size_t>(main - module.functions.begin()));
+    std::vector<IRFunction> kept;
+    for (std::size_t i = 0; i < module.functions.size(); ++i) {
+        if (reached[i]) {
+            kept.push_back(std::move(module.functions[i]));
+        }
+    }
+    const bool removed = kept.size() < module.functions.size();
+    module.functions = std::move(kept);
+    return removed;
+}
+
+#endif //CALLGRAPH_HPP
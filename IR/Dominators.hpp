@@ -0,0 +1,152 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef DOMINATORS_HPP
+#define DOMINATORS_HPP
+
+#include <algorithm>
+#include <vector>
+#include "IR.hpp"
+
+// Dominator tree of a function's control flow graph, computed with the
+// iterative algorithm of Cooper, Harvey and Kennedy over reverse postorder.
+// Blocks that cannot be reached from the entry have no dominator and are
+// left out of the order.
+class DominatorTree {
+    public:
+    static constexpr BlockId None = NoVReg;
+
+    explicit DominatorTree(const IRFunction& function)
+        : idom(function.blocks.size(), None), orderIndex(function.blocks.size(), None) {
+        if (function.blocks.empty()) {
+            return;
+        }
+        ComputeOrder(function);
+        const auto predecessors = function.Predecessors();
+        idom[0] = 0;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (std::size_t i = 1; i < order.size(); ++i) {
+                const BlockId block = order[i];
+                BlockId newIdom = None;
+                for (const BlockId predecessor : predecessors[block]) {
+                    if (idom[predecessor] == None) {
+                        continue;
+                    }
+                    newIdom = newIdom == None ? predecessor : Intersect(predecessor, newIdom);
+                }
+                if (idom[block] != newIdom) {
+                    idom[block] = newIdom;
+                    changed = true;
+                }
+            }
+        }
+
+        children.resize(function.blocks.size());
+        for (const BlockId block : order) {
+            if (block != 0) {
+                children[idom[block]].push_back(block);
+            }
+        }
+    }
+
+    [[nodiscard]] bool isReachable(BlockId block) const { return idom[block] != None; }
+
+    // Immediate dominator; the entry is its own.
+    [[nodiscard]] BlockId ImmediateDominator(BlockId block) const { return idom[block]; }
+
+    [[nodiscard]] const std::vector<BlockId>& Children(BlockId block) const { return children[block]; }
+
+    // Reachable blocks in reverse postorder, entry first.
+    [[nodiscard]] const std::vector<BlockId>& ReversePostorder() const { return order; }
+
+    // Blocks where the dominance of each block ends: the join points at
+    // which a value defined in it would need a phi.
+    [[nodiscard]] std::vector<std::vector<BlockId>>
+    Frontiers(const IRFunction& function) const {
+        std::vector<std::vector<BlockId>> frontiers(function.blocks.size());
+        const auto predecessors = function.Predecessors();
+        for (const BlockId block : order) {
+            if (predecessors[block].size() < 2) {
+                continue;
+            }
+            for (BlockId runner : predecessors[block]) {
+                while (isReachable(runner) && runner != idom[block]) {
+                    if (std::ranges::find(frontiers[runner], block) == frontiers[runner].end()) {
+                        frontiers[runner].push_back(block);
+                    }
+                    runner = idom[runner];
+                }
+            }
+        }
+        return frontiers;
+    }
+
+    // Whether every path from the entry to block passes through dominator.
+    // Vacuously true for unreachable blocks.
+    [[nodiscard]] bool
+    Dominates(BlockId dominator, BlockId block) const {
+        if (!isReachable(block)) {
+            return true;
+        }
+        while (block != dominator) {
+            if (block == 0) {
+                return false;
+            }
+            block = idom[block];
+        }
+        return true;
+    }
+
+    private:
+    std::vector<BlockId> idom;
+    std::vector<BlockId> orderIndex;
+    std::vector<BlockId> order;
+    std::vector<std::vector<BlockId>> children;
+
+    BlockId
+    Intersect(BlockId a, BlockId b) const {
+        while (a != b) {
+            while (orderIndex[a] > orderIndex[b]) {
+                a = idom[a];
+            }
+            while (orderIndex[b] > orderIndex[a]) {
+                b = idom[b];
+            }
+        }
+        return a;
+    }
+
+    // Depth-first search with an explicit stack of (block, next successor).
+    void
+    ComputeOrder(const IRFunction& function) {
+        std::vector<bool> visited(function.blocks.size(), false);
+        std::vector<std::pair<BlockId, std::size_t>> stack = {{0, 0}};
+        std::vector<std::vector<BlockId>> successors(function.blocks.size());
+        for (const BasicBlock& block : function.blocks) {
+            successors[block.id] = block.Successors();
+        }
+        visited[0] = true;
+        while (!stack.empty()) {
+            auto& [block, next] = stack.back();
+            if (next < successors[block].size()) {
+                const BlockId successor = successors[block][next++];
+                if (!visited[successor]) {
+                    visited[successor] = true;
+                    stack.emplace_back(successor, 0);
+                }
+                continue;
+            }
+            order.push_back(block);
+            stack.pop_back();
+        }
+        std::reverse(order.begin(), order.end());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            orderIndex[order[i]] = static_cast<BlockId>(i);
+        }
+    }
+};
+
+#endif //DOMINATORS_HPP
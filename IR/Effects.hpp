@@ -0,0 +1,58 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef EFFECTS_HPP
+#define EFFECTS_HPP
+
+#include <algorithm>
+#include "CallGraph.hpp"
+
+// What calling a function may do besides computing its result, from least
+// to most.
+enum class Effect : std::uint8_t {
+    Pure,     // result depends only on the arguments
+    ReadOnly, // may also read memory outside its frame, but never writes it
+    Unknown,  // may write memory, or cannot be seen (defined in another unit)
+};
+
+// Effects of every function of a module. Slots are private to their frame,
+// so loads and stores have no effect a caller can see; a function is as
+// pure as the least pure function it calls, and functions of another unit
+// are Unknown. Effects are found bottom-up over the call graph, every
+// member of a recursive component sharing the join of the whole component.
+//
+// A pure function need not terminate. Calls to it may be merged, since the
+// first one would not return either, but not deleted.
+class EffectAnalysis {
+    public:
+    EffectAnalysis(const IRModule& module, const CallGraph& graph)
+        : graph(graph), effects(module.functions.size(), Effect::Pure) {
+        for (const auto& component : graph.BottomUp()) {
+            Effect effect = Effect::Pure;
+            for (const std::size_t function : component) {
+                if (graph.CallsExternal(function)) {
+                    effect = Effect::Unknown;
+                }
+                for (const std::size_t callee : graph.Callees(function)) {
+                    effect = std::max(effect, effects[callee]);
+                }
+            }
+            for (const std::size_t function : component) {
+                effects[function] = effect;
+            }
+        }
+    }
+
+    [[nodiscard]] Effect
+    Of(SymbolId function) const {
+        const auto index = graph.Find(function);
+        return index ? effects[*index] : Effect::Unknown;
+    }
+
+    private:
+    const CallGraph& graph;
+    std::vector<Effect> effects;
+};
+
+#endif //EFFECTS_HPP
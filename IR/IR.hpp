@@ -0,0 +1,193 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef IR_HPP
+#define IR_HPP
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "../Lexer/Interner.hpp"
+
+// Typed SSA intermediate representation between the AST and the backends.
+//
+// A function is a list of basic blocks; blocks[0] is the entry and a block's
+// id is its index. Every block ends in exactly one terminator (Br or Ret) and
+// starts with its phis. Values live in virtual registers that are assigned
+// exactly once; a parameter's register is defined on entry. Locals start out
+// in stack slots that are read and written with Load and Store, so lowering
+// never has to build phis itself.
+
+enum class IRType : std::uint8_t {
+    Void,
+    I64,
+};
+
+using VReg = std::uint32_t;
+inline constexpr VReg NoVReg = std::numeric_limits<VReg>::max();
+using BlockId = std::uint32_t;
+using SlotId = std::uint32_t;
+
+// Instruction input: a virtual register or a 64-bit immediate.
+struct Operand {
+    enum class Kind : std::uint8_t { Reg, Imm };
+    Kind kind = Kind::Imm;
+    VReg reg = NoVReg;
+    std::int64_t imm = 0;
+
+    static Operand Reg(VReg reg) { return {Kind::Reg, reg, 0}; }
+    static Operand Imm(std::int64_t value) { return {Kind::Imm, NoVReg, value}; }
+    [[nodiscard]] bool isReg() const { return kind == Kind::Reg; }
+    [[nodiscard]] bool isImm() const { return kind == Kind::Imm; }
+    bool operator==(const Operand&) const = default;
+};
+
+enum class Opcode : std::uint8_t {
+    Add,   // result = operands[0] + operands[1]
+    Sub,   // result = operands[0] - operands[1]
+    Mul,   // result = operands[0] * operands[1]
+    SDiv,  // result = operands[0] / operands[1], truncating
+    Shl,   // result = operands[0] << operands[1]
+    AShr,  // result = operands[0] >> operands[1], shifting in the sign
+    LShr,  // result = operands[0] >> operands[1], shifting in zeros
+    MulHi, // result = high 64 bits of the signed 128-bit operands[0] * operands[1]
+    Neg,   // result = -operands[0]
+    Copy,  // result = operands[0]
+    Load,  // result = slot
+    Store, // slot = operands[0]
+    Call,  // result = callee(operands...)
+    Phi,   // result = operands[i] when entered from blocks[i]
+    Br,    // continue at blocks[0]
+    Ret,   // return operands[0]
+};
+
+struct Instruction {
+    Opcode op;
+    VReg result = NoVReg;
+    std::vector<Operand> operands = {};
+    std::vector<BlockId> blocks = {}; // Br target, Phi incoming blocks
+    SlotId slot = 0;                  // Load, Store
+    SymbolId callee = InvalidSymbol;  // Call
+
+    [[nodiscard]] bool isTerminator() const { return op == Opcode::Br || op == Opcode::Ret; }
+};
+
+struct BasicBlock {
+    BlockId id;
+    std::vector<Instruction> instructions;
+
+    [[nodiscard]] const Instruction& terminator() const { return instructions.back(); }
+    [[nodiscard]] bool isTerminated() const { return !instructions.empty() && instructions.back().isTerminator(); }
+
+    [[nodiscard]] std::vector<BlockId> Successors() const {
+        if (isTerminated() && terminator().op == Opcode::Br) {
+            return terminator().blocks;
+        }
+        return {};
+    }
+};
+
+// A local variable in memory. Passes may promote it to registers.
+struct StackSlot {
+    SymbolId name;
+    IRType type;
+};
+
+struct IRFunction {
+    SymbolId name;
+    IRType returnType = IRType::I64;
+    // Registers holding the arguments on entry, defined before bb0 runs.
+    std::vector<VReg> parameters = {};
+    std::vector<BasicBlock> blocks = {};
+    std::vector<IRType> registers = {}; // type of each virtual register
+    std::vector<StackSlot> slots = {};
+
+    VReg NewRegister(IRType type) {
+        registers.push_back(type);
+        return static_cast<VReg>(registers.size() - 1);
+    }
+
+    BlockId NewBlock() {
+        const auto id = static_cast<BlockId>(blocks.size());
+        blocks.push_back({id, {}});
+        return id;
+    }
+
+    // Deletes the blocks marked in removed and renumbers the rest in order.
+    // Branches must not target a removed block; phi operands arriving from
+    // one are dropped.
+    void RemoveBlocks(const std::vector<bool>& removed) {
+        std::vector<BlockId> renumbered(blocks.size(), 0);
+        BlockId next = 0;
+        for (BlockId id = 0; id < blocks.size(); ++id) {
+            renumbered[id] = next;
+            next += removed[id] ? 0 : 1;
+        }
+        std::vector<BasicBlock> kept;
+        kept.reserve(next);
+        for (BasicBlock& block : blocks) {
+            if (removed[block.id]) {
+                continue;
+            }
+            block.id = renumbered[block.id];
+            for (Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Phi) {
+                    std::size_t out = 0;
+                    for (std::size_t i = 0; i < instruction.blocks.size(); ++i) {
+                        if (!removed[instruction.blocks[i]]) {
+                            instruction.operands[out] = instruction.operands[i];
+                            instruction.blocks[out++] = renumbered[instruction.blocks[i]];
+                        }
+                    }
+                    instruction.operands.resize(out);
+                    instruction.blocks.resize(out);
+                } else {
+                    for (BlockId& target : instruction.blocks) {
+                        target = renumbered[target];
+                    }
+                }
+            }
+            kept.push_back(std::move(block));
+        }
+        blocks = std::move(kept);
+    }
+
+    [[nodiscard]] std::vector<std::vector<BlockId>> Predecessors() const {
+        std::vector<std::vector<BlockId>> predecessors(blocks.size());
+        for (const BasicBlock& block : blocks) {
+            for (const BlockId successor : block.Successors()) {
+                predecessors[successor].push_back(block.id);
+            }
+        }
+        return predecessors;
+    }
+};
+
+struct IRModule {
+    std::vector<IRFunction> functions;
+};
+
+inline std::uint32_t
+TypeSize(IRType type) {
+    return type == IRType::I64 ? 8 : 0;
+}
+
+// Semantics of MulHi, from 32-bit halves: the unsigned high product, less
+// each operand wherever the other is negative.
+inline std::int64_t
+MultiplyHigh(std::int64_t lhs, std::int64_t rhs) {
+    const auto a = static_cast<std::uint64_t>(lhs);
+    const auto b = static_cast<std::uint64_t>(rhs);
+    const std::uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+    const std::uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    const std::uint64_t low = aLow * bLow;
+    const std::uint64_t middle1 = aHigh * bLow + (low >> 32);
+    const std::uint64_t middle2 = aLow * bHigh + (middle1 & 0xFFFFFFFF);
+    std::uint64_t high = aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32);
+    high -= lhs < 0 ? b : 0;
+    high -= rhs < 0 ? a : 0;
+    return static_cast<std::int64_t>(high);
+}
+
+#endif //IR_HPP
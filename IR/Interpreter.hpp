@@ -0,0 +1,159 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef INTERPRETER_HPP
+#define INTERPRETER_HPP
+
+#include <optional>
+#include <unordered_map>
+#include "IR.hpp"
+
+// Runs IR functions at compile time. Execution gives up, returning nothing,
+// after a number of instructions or at a call depth beyond its limits, on a
+// call to a function the module does not define or with the wrong number of
+// arguments, and on division by zero, whose result differs between targets.
+// Calls run on an explicit stack of frames, so deep recursion in the program
+// does not recurse in the compiler.
+class Interpreter {
+    public:
+    struct Limits {
+        std::uint64_t steps = 100000;
+        std::uint32_t depth = 256;
+    };
+
+    Interpreter(const IRModule& module, Limits limits) : limits(limits) {
+        for (const IRFunction& function : module.functions) {
+            functions.emplace(function.name, &function);
+        }
+    }
+
+    [[nodiscard]] std::optional<std::int64_t>
+    Call(SymbolId name, const std::vector<std::int64_t>& arguments = {}) const {
+        const auto callee = functions.find(name);
+        if (callee == functions.end() || callee->second->parameters.size() != arguments.size()) {
+            return std::nullopt;
+        }
+        std::uint64_t steps = 0;
+        std::vector<Frame> stack;
+        stack.emplace_back(*callee->second, arguments);
+        while (true) {
+            Frame& frame = stack.back();
+            const Instruction& instruction = frame.function->blocks[frame.block].instructions[frame.index];
+            if (++steps > limits.steps) {
+                return std::nullopt;
+            }
+            const auto value = [&](std::size_t i) {
+                const Operand& operand = instruction.operands[i];
+                return operand.isReg() ? frame.registers[operand.reg] : operand.imm;
+            };
+            const auto wrap = [](std::uint64_t bits) { return static_cast<std::int64_t>(bits); };
+            const auto a = [&] { return static_cast<std::uint64_t>(value(0)); };
+            const auto b = [&] { return static_cast<std::uint64_t>(value(1)); };
+            std::int64_t result = 0;
+            switch (instruction.op) {
+                case Opcode::Add: result = wrap(a() + b()); break;
+                case Opcode::Sub: result = wrap(a() - b()); break;
+                case Opcode::Mul: result = wrap(a() * b()); break;
+                case Opcode::SDiv:
+                    if (value(1) == 0) {
+                        return std::nullopt;
+                    }
+                    result = value(1) == -1 ? wrap(0 - a()) : value(0) / value(1);
+                    break;
+                case Opcode::Shl: result = wrap(a() << (b() & 63)); break;
+                case Opcode::AShr: result = value(0) >> (b() & 63); break;
+                case Opcode::LShr: result = wrap(a() >> (b() & 63)); break;
+                case Opcode::MulHi: result = MultiplyHigh(value(0), value(1)); break;
+                case Opcode::Neg: result = wrap(0 - a()); break;
+                case Opcode::Copy: result = value(0); break;
+                case Opcode::Load: result = frame.slots[instruction.slot]; break;
+                case Opcode::Store:
+                    frame.slots[instruction.slot] = value(0);
+                    ++frame.index;
+                    continue;
+                case Opcode::Call: {
+                    const auto found = functions.find(instruction.callee);
+                    if (found == functions.end() || found->second->parameters.size() != instruction.operands.size() ||
+                        stack.size() >= limits.depth) {
+                        return std::nullopt;
+                    }
+                    std::vector<std::int64_t> arguments(instruction.operands.size());
+                    for (std::size_t i = 0; i < arguments.size(); ++i) {
+                        arguments[i] = value(i);
+                    }
+                    // Resumes with the result once the callee returns.
+                    stack.emplace_back(*found->second, arguments);
+                    continue;
+                }
+                case Opcode::Phi:
+                    // Phis were evaluated together on entering the block.
+                    ++frame.index;
+                    continue;
+                case Opcode::Br:
+                    frame.Enter(instruction.blocks[0]);
+                    continue;
+                case Opcode::Ret: {
+                    const std::int64_t returned = instruction.operands.empty() ? 0 : value(0);
+                    stack.pop_back();
+                    if (stack.empty()) {
+                        return returned;
+                    }
+                    Frame& caller = stack.back();
+                    const Instruction& call = caller.function->blocks[caller.block].instructions[caller.index];
+                    if (call.result != NoVReg) {
+                        caller.registers[call.result] = returned;
+                    }
+                    ++caller.index;
+                    continue;
+                }
+            }
+            frame.registers[instruction.result] = result;
+            ++frame.index;
+        }
+    }
+
+    private:
+    struct Frame {
+        const IRFunction* function;
+        BlockId block = 0;
+        std::size_t index = 0;
+        std::vector<std::int64_t> registers;
+        std::vector<std::int64_t> slots;
+
+        Frame(const IRFunction& function, const std::vector<std::int64_t>& arguments)
+            : function(&function), registers(function.registers.size(), 0), slots(function.slots.size(), 0) {
+            for (std::size_t i = 0; i < arguments.size(); ++i) {
+                registers[function.parameters[i]] = arguments[i];
+            }
+        }
+
+        // Moves to target, giving its phis the values passed from here.
+        void
+        Enter(BlockId target) {
+            const auto& instructions = function->blocks[target].instructions;
+            std::vector<std::pair<VReg, std::int64_t>> incoming;
+            for (const Instruction& phi : instructions) {
+                if (phi.op != Opcode::Phi) {
+                    break;
+                }
+                for (std::size_t i = 0; i < phi.blocks.size(); ++i) {
+                    if (phi.blocks[i] == block) {
+                        const Operand& operand = phi.operands[i];
+                        incoming.emplace_back(phi.result, operand.isReg() ? registers[operand.reg] : operand.imm);
+                    }
+                }
+            }
+            for (const auto& [reg, value] : incoming) {
+                registers[reg] = value;
+            }
+            block = target;
+            index = 0;
+        }
+    };
+
+    Limits limits;
+    std::unordered_map<SymbolId, const IRFunction*> functions;
+};
+
+#endif //INTERPRETER_HPP
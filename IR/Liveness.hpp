@@ -0,0 +1,168 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef LIVENESS_HPP
+#define LIVENESS_HPP
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include "Dominators.hpp"
+
+// Set of virtual registers, or of stack slots, as a bit vector.
+class RegisterSet {
+    public:
+    explicit RegisterSet(std::size_t size = 0) : words((size + 63) / 64, 0) {}
+
+    [[nodiscard]] bool contains(VReg reg) const { return words[reg / 64] >> (reg % 64) & 1; }
+    void insert(VReg reg) { words[reg / 64] |= std::uint64_t{1} << (reg % 64); }
+    void erase(VReg reg) { words[reg / 64] &= ~(std::uint64_t{1} << (reg % 64)); }
+
+    // Adds the members of other, returning whether anything was new.
+    bool
+    Merge(const RegisterSet& other) {
+        bool grew = false;
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            const std::uint64_t merged = words[i] | other.words[i];
+            grew |= merged != words[i];
+            words[i] = merged;
+        }
+        return grew;
+    }
+
+    template <typename Visit>
+    void
+    ForEach(Visit&& visit) const {
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            for (std::uint64_t word = words[i]; word != 0; word &= word - 1) {
+                visit(static_cast<VReg>(i * 64 + std::countr_zero(word)));
+            }
+        }
+    }
+
+    bool operator==(const RegisterSet&) const = default;
+
+    private:
+    std::vector<std::uint64_t> words;
+};
+
+// Registers live into and out of every block. A phi defines its result at
+// the start of its block and uses each operand at the end of the matching
+// predecessor, so phi operands are live out of that predecessor only.
+class Liveness {
+    public:
+    std::vector<RegisterSet> liveIn;
+    std::vector<RegisterSet> liveOut;
+
+    explicit Liveness(const IRFunction& function)
+        : liveIn(function.blocks.size(), RegisterSet(function.registers.size())),
+          liveOut(function.blocks.size(), RegisterSet(function.registers.size())) {
+        const std::size_t count = function.blocks.size();
+        // Upward-exposed uses and definitions of each block, phis excluded.
+        std::vector<RegisterSet> uses(count, RegisterSet(function.registers.size()));
+        std::vector<RegisterSet> defs(count, RegisterSet(function.registers.size()));
+        // Phi operands each block passes to its successors.
+        std::vector<RegisterSet> phiUses(count, RegisterSet(function.registers.size()));
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Phi) {
+                    for (std::size_t i = 0; i < instruction.operands.size(); ++i) {
+                        if (instruction.operands[i].isReg()) {
+                            phiUses[instruction.blocks[i]].insert(instruction.operands[i].reg);
+                        }
+                    }
+                    defs[block.id].insert(instruction.result);
+                    continue;
+                }
+                for (const Operand& operand : instruction.operands) {
+                    if (operand.isReg() && !defs[block.id].contains(operand.reg)) {
+                        uses[block.id].insert(operand.reg);
+                    }
+                }
+                if (instruction.result != NoVReg) {
+                    defs[block.id].insert(instruction.result);
+                }
+            }
+        }
+
+        // Backward dataflow, visiting blocks in postorder until stable.
+        const DominatorTree dominators(function);
+        const auto& order = dominators.ReversePostorder();
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                const BasicBlock& block = function.blocks[*it];
+                RegisterSet out = phiUses[block.id];
+                for (const BlockId successor : block.Successors()) {
+                    out.Merge(liveIn[successor]);
+                }
+                RegisterSet in = uses[block.id];
+                out.ForEach([&](VReg reg) {
+                    if (!defs[block.id].contains(reg)) {
+                        in.insert(reg);
+                    }
+                });
+                if (out != liveOut[block.id] || in != liveIn[block.id]) {
+                    liveOut[block.id] = std::move(out);
+                    liveIn[block.id] = std::move(in);
+                    changed = true;
+                }
+            }
+        }
+    }
+};
+
+// Stack slots live into and out of every block. A slot is live where a
+// load may read it before the next store.
+class SlotLiveness {
+    public:
+    std::vector<RegisterSet> liveIn;
+    std::vector<RegisterSet> liveOut;
+
+    explicit SlotLiveness(const IRFunction& function)
+        : liveIn(function.blocks.size(), RegisterSet(function.slots.size())),
+          liveOut(function.blocks.size(), RegisterSet(function.slots.size())) {
+        const std::size_t count = function.blocks.size();
+        // Slots each block reads before writing, and slots it writes.
+        std::vector<RegisterSet> uses(count, RegisterSet(function.slots.size()));
+        std::vector<RegisterSet> defs(count, RegisterSet(function.slots.size()));
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Load && !defs[block.id].contains(instruction.slot)) {
+                    uses[block.id].insert(instruction.slot);
+                } else if (instruction.op == Opcode::Store) {
+                    defs[block.id].insert(instruction.slot);
+                }
+            }
+        }
+
+        const DominatorTree dominators(function);
+        const auto& order = dominators.ReversePostorder();
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                const BlockId id = *it;
+                RegisterSet out(function.slots.size());
+                for (const BlockId successor : function.blocks[id].Successors()) {
+                    out.Merge(liveIn[successor]);
+                }
+                RegisterSet in = uses[id];
+                out.ForEach([&](SlotId slot) {
+                    if (!defs[id].contains(slot)) {
+                        in.insert(slot);
+                    }
+                });
+                if (out != liveOut[id] || in != liveIn[id]) {
+                    liveOut[id] = std::move(out);
+                    liveIn[id] = std::move(in);
+                    changed = true;
+                }
+            }
+        }
+    }
+};
+
+#endif //LIVENESS_HPP
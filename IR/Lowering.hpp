@@ -0,0 +1,259 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef LOWERING_HPP
+#define LOWERING_HPP
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IR.hpp"
+#include "../Parser/ASTVisitor.hpp"
+
+// Lowers a parsed unit to IR. Every local gets a stack slot: declarations
+// store to it and uses load from it, so no phis are needed here. Parameters
+// are locals whose slot is stored from their register on entry. Statements
+// after a return land in a fresh block with no predecessors, and a function
+// that falls off its end returns 0.
+class Lowering : public ASTVisitor<Lowering> {
+    public:
+    static IRModule
+    Lower(const CompilationUnit& program) {
+        Lowering lowering;
+        for (const ASTNode* node : program.nodes) {
+            if (auto function = node->as<FunctionDef>()) {
+                lowering.parameterCounts[function->name] = function->parameters.size();
+            }
+        }
+        for (const ASTNode* node : program.nodes) {
+            // Statements only lower into a function; there is none here.
+            if (node->is<Return>() || node->is<Declare>() || node->is<ExpStatement>()) {
+                lowering.VisitNode(node);
+            }
+            lowering.Visit(node);
+        }
+        return std::move(lowering.module);
+    }
+
+    private:
+    friend class ASTVisitor<Lowering>;
+
+    static constexpr SlotId NoSlot = std::numeric_limits<SlotId>::max();
+
+    IRModule module;
+    IRFunction* function = nullptr;
+    BlockId block = 0;
+    // Slot of each local of the current function, indexed by SymbolId.
+    std::vector<SlotId> slotOf = std::vector<SlotId>(Interner::size(), NoSlot);
+    // Parameter count of each function the unit defines, so calls to them
+    // can be checked; calls to other functions are left to the linker.
+    std::unordered_map<SymbolId, std::size_t> parameterCounts;
+
+    // Pending expression on the explicit lowering stack; stage counts how
+    // many children have already been lowered. Their values wait on values.
+    struct ExpFrame {
+        const Exp* exp;
+        std::size_t stage;
+    };
+    std::vector<ExpFrame> expStack;
+    std::vector<Operand> values;
+
+    Instruction&
+    Append(Instruction instruction) {
+        return function->blocks[block].instructions.emplace_back(std::move(instruction));
+    }
+
+    Operand
+    AppendValue(Instruction instruction) {
+        instruction.result = function->NewRegister(IRType::I64);
+        return Operand::Reg(Append(std::move(instruction)).result);
+    }
+
+    SlotId
+    SlotFor(SymbolId name) const {
+        if (name >= slotOf.size() || slotOf[name] == NoSlot) {
+            throw std::runtime_error("Use of undeclared variable '" + std::string(Interner::spelling(name)) +
+                                     "' in function '" + std::string(Interner::spelling(function->name)) + "'");
+        }
+        return slotOf[name];
+    }
+
+    Operand
+    PopValue() {
+        const Operand value = values.back();
+        values.pop_back();
+        return value;
+    }
+
+    static Opcode
+    ToOpcode(BinaryOperator op) {
+        switch (op) {
+            case BinaryOperator::Add: return Opcode::Add;
+            case BinaryOperator::Sub: return Opcode::Sub;
+            case BinaryOperator::Mul: return Opcode::Mul;
+            case BinaryOperator::Div: return Opcode::SDiv;
+        }
+        return Opcode::Add;
+    }
+
+    // Returns the value of exp, lowering operands left to right. Walks the
+    // tree with an explicit stack, so arbitrarily deep expressions use
+    // constant native stack.
+    Operand
+    LowerExp(const Exp* root) {
+        expStack.push_back({root, 0});
+        while (!expStack.empty()) {
+            ExpFrame& frame = expStack.back();
+            const std::size_t stage = frame.stage++;
+            const Exp* exp = frame.exp;
+            switch (exp->kind) {
+                case NodeKind::Literal:
+                    values.push_back(Operand::Imm(static_cast<const Literal*>(exp)->value));
+                    expStack.pop_back();
+                    break;
+                case NodeKind::Var:
+                    values.push_back(AppendValue({.op = Opcode::Load, .slot = SlotFor(static_cast<const Var*>(exp)->name)}));
+                    expStack.pop_back();
+                    break;
+                case NodeKind::BinOp: {
+                    auto binOp = static_cast<const BinOp*>(exp);
+                    if (stage < 2) {
+                        expStack.push_back({stage == 0 ? binOp->lhs : binOp->rhs, 0});
+                        break;
+                    }
+                    const Operand rhs = PopValue();
+                    const Operand lhs = PopValue();
+                    if (binOp->op == BinaryOperator::Div && rhs.isImm() && rhs.imm == 0) {
+                        throw std::runtime_error("Division by zero in function '" + std::string(Interner::spelling(function->name)) + "'");
+                    }
+                    values.push_back(AppendValue({.op = ToOpcode(binOp->op), .operands = {lhs, rhs}}));
+                    expStack.pop_back();
+                    break;
+                }
+                case NodeKind::UnOp: {
+                    auto unOp = static_cast<const UnOp*>(exp);
+                    if (stage == 0) {
+                        expStack.push_back({unOp->operand, 0});
+                        break;
+                    }
+                    values.push_back(AppendValue({.op = Opcode::Neg, .operands = {PopValue()}}));
+                    expStack.pop_back();
+                    break;
+                }
+                case NodeKind::Assign: {
+                    auto assign = static_cast<const Assign*>(exp);
+                    if (stage == 0) {
+                        SlotFor(assign->name);
+                        expStack.push_back({assign->value, 0});
+                        break;
+                    }
+                    // The assignment's value is the stored value.
+                    Append({.op = Opcode::Store, .operands = {values.back()}, .slot = SlotFor(assign->name)});
+                    expStack.pop_back();
+                    break;
+                }
+                case NodeKind::FunctionCall: {
+                    auto funcCall = static_cast<const FunctionCall*>(exp);
+                    if (stage < funcCall->arguments.size()) {
+                        expStack.push_back({funcCall->arguments[stage], 0});
+                        break;
+                    }
+                    if (const auto callee = parameterCounts.find(funcCall->name);
+                        callee != parameterCounts.end() && callee->second != funcCall->arguments.size()) {
+                        throw std::runtime_error("Function '" + std::string(Interner::spelling(funcCall->name)) + "' takes " +
+                                                 std::to_string(callee->second) + " arguments but " +
+                                                 std::to_string(funcCall->arguments.size()) + " were given");
+                    }
+                    std::vector<Operand> arguments(values.end() - static_cast<std::ptrdiff_t>(funcCall->arguments.size()), values.end());
+                    values.resize(values.size() - funcCall->arguments.size());
+                    values.push_back(AppendValue({.op = Opcode::Call, .operands = std::move(arguments), .callee = funcCall->name}));
+                    expStack.pop_back();
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Objects are not supported by code generation yet (in function '" +
+                                             std::string(Interner::spelling(function->name)) + "')");
+            }
+        }
+        return PopValue();
+    }
+
+    // Code after a return goes to a new block that nothing branches to.
+    void
+    StartStatement() {
+        if (function->blocks[block].isTerminated()) {
+            block = function->NewBlock();
+        }
+    }
+
+    void
+    VisitReturn(const Return* returnStmt) {
+        StartStatement();
+        const Operand value = LowerExp(returnStmt->expression);
+        Append({.op = Opcode::Ret, .operands = {value}});
+    }
+
+    void
+    VisitDeclare(const Declare* declareStmt) {
+        StartStatement();
+        const Operand value = declareStmt->initializer ? LowerExp(declareStmt->initializer) : Operand::Imm(0);
+        DeclareLocal(declareStmt->name, value);
+    }
+
+    // Gives name a new slot holding value.
+    void
+    DeclareLocal(SymbolId name, Operand value) {
+        const auto slot = static_cast<SlotId>(function->slots.size());
+        function->slots.push_back({name, IRType::I64});
+        if (name >= slotOf.size()) {
+            slotOf.resize(name + 1, NoSlot);
+        }
+        slotOf[name] = slot;
+        Append({.op = Opcode::Store, .operands = {value}, .slot = slot});
+    }
+
+    void
+    VisitExpStatement(const ExpStatement* expStmt) {
+        StartStatement();
+        LowerExp(expStmt->expression);
+    }
+
+    void
+    VisitFunctionDef(const FunctionDef* func) {
+        module.functions.push_back({.name = func->name});
+        function = &module.functions.back();
+        block = function->NewBlock();
+        for (const Declare* parameter : func->parameters) {
+            const VReg reg = function->NewRegister(IRType::I64);
+            function->parameters.push_back(reg);
+            DeclareLocal(parameter->name, Operand::Reg(reg));
+        }
+
+        for (const Statement* stmt : func->statements) {
+            if (stmt->is<ClassDef>() || stmt->is<NamespaceDef>() || stmt->is<Import>()) {
+                continue;
+            }
+            Visit(stmt);
+        }
+        if (!function->blocks[block].isTerminated()) {
+            Append({.op = Opcode::Ret, .operands = {Operand::Imm(0)}});
+        }
+
+        for (const StackSlot& slot : function->slots) {
+            slotOf[slot.name] = NoSlot;
+        }
+    }
+
+    void
+    VisitNode(const ASTNode*) {
+        throw std::runtime_error("Only functions, classes, namespaces and imports may appear at the top level");
+    }
+
+    void VisitClassDef(const ClassDef*) {}
+    void VisitNamespaceDef(const NamespaceDef*) {}
+    void VisitImport(const Import*) {}
+};
+
+#endif //LOWERING_HPP
@@ -0,0 +1,53 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef PASSMANAGER_HPP
+#define PASSMANAGER_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Verifier.hpp"
+
+// A transformation over a whole module.
+class Pass {
+    public:
+    virtual ~Pass() = default;
+    [[nodiscard]] virtual std::string_view Name() const = 0;
+    // Returns whether the module was changed.
+    virtual bool Run(IRModule& module) = 0;
+};
+
+// Runs passes in the order they were added. The module is verified before
+// the first pass and after every pass that changed it, so a broken pass is
+// reported by name instead of surfacing as bad assembly.
+class PassManager {
+    public:
+    bool verifyEach = true;
+
+    void
+    Add(std::unique_ptr<Pass> pass) {
+        passes.push_back(std::move(pass));
+    }
+
+    [[nodiscard]] const std::vector<std::unique_ptr<Pass>>& getPasses() const { return passes; }
+
+    void
+    Run(IRModule& module) const {
+        if (verifyEach) {
+            Verifier::Verify(module, "after lowering");
+        }
+        for (const auto& pass : passes) {
+            if (pass->Run(module) && verifyEach) {
+                Verifier::Verify(module, "after pass '" + std::string(pass->Name()) + "'");
+            }
+        }
+    }
+
+    private:
+    std::vector<std::unique_ptr<Pass>> passes;
+};
+
+#endif //PASSMANAGER_HPP
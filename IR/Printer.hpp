@@ -0,0 +1,142 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef IRPRINTER_HPP
+#define IRPRINTER_HPP
+
+#include <sstream>
+#include <string>
+#include "IR.hpp"
+
+// Text form of the IR, as written by --emit-ir:
+//
+//   function @main() i64 {
+//     $0 = slot i64 ; x
+//   bb0:
+//     store $0, 5
+//     %0 = load $0
+//     %1 = add %0, 3
+//     ret %1
+//   }
+class IRPrinter {
+    public:
+    static std::string
+    Print(const IRModule& module) {
+        std::stringstream out;
+        for (const IRFunction& function : module.functions) {
+            Print(out, function);
+        }
+        return out.str();
+    }
+
+    static std::string
+    Print(const IRFunction& function) {
+        std::stringstream out;
+        Print(out, function);
+        return out.str();
+    }
+
+    static std::string_view
+    Name(Opcode op) {
+        switch (op) {
+            case Opcode::Add: return "add";
+            case Opcode::Sub: return "sub";
+            case Opcode::Mul: return "mul";
+            case Opcode::SDiv: return "sdiv";
+            case Opcode::Shl: return "lsl";
+            case Opcode::AShr: return "asr";
+            case Opcode::LShr: return "lsr";
+            case Opcode::MulHi: return "smulh";
+            case Opcode::Neg: return "neg";
+            case Opcode::Copy: return "copy";
+            case Opcode::Load: return "load";
+            case Opcode::Store: return "store";
+            case Opcode::Call: return "call";
+            case Opcode::Phi: return "phi";
+            case Opcode::Br: return "br";
+            case Opcode::Ret: return "ret";
+        }
+        return "?";
+    }
+
+    static std::string_view
+    Name(IRType type) {
+        return type == IRType::I64 ? "i64" : "void";
+    }
+
+    static std::string
+    Format(const Operand& operand) {
+        return operand.isReg() ? "%" + std::to_string(operand.reg) : std::to_string(operand.imm);
+    }
+
+    static std::string
+    Format(const Instruction& instruction) {
+        std::string text;
+        if (instruction.result != NoVReg) {
+            text += "%" + std::to_string(instruction.result) + " = ";
+        }
+        text += Name(instruction.op);
+        switch (instruction.op) {
+            case Opcode::Load:
+                text += " $" + std::to_string(instruction.slot);
+                break;
+            case Opcode::Store:
+                text += " $" + std::to_string(instruction.slot) + ", " + Format(instruction.operands[0]);
+                break;
+            case Opcode::Call:
+                text += " @" + std::string(Interner::spelling(instruction.callee)) + "(";
+                for (std::size_t i = 0; i < instruction.operands.size(); ++i) {
+                    text += (i > 0 ? ", " : "") + Format(instruction.operands[i]);
+                }
+                text += ")";
+                break;
+            case Opcode::Phi:
+                for (std::size_t i = 0; i < instruction.operands.size(); ++i) {
+                    text += (i > 0 ? ", [" : " [") + Format(instruction.operands[i]) + ", bb" +
+                            std::to_string(instruction.blocks[i]) + "]";
+                }
+                break;
+            case Opcode::Br:
+                text += " bb" + std::to_string(instruction.blocks[0]);
+                break;
+            default:
+                for (std::size_t i = 0; i < instruction.operands.size(); ++i) {
+                    text += (i > 0 ? ", " : " ") + Format(instruction.operands[i]);
+                }
+                break;
+        }
+        return text;
+    }
+
+    private:
+    static void
+    Print(std::stringstream& out, const IRFunction& function) {
+        out << "function @" << Interner::spelling(function.name) << "(";
+        for (std::size_t i = 0; i < function.parameters.size(); ++i) {
+            out << (i > 0 ? ", %" : "%") << function.parameters[i];
+        }
+        out << ") " << Name(function.returnType) << " {\n";
+        for (std::size_t i = 0; i < function.slots.size(); ++i) {
+            out << "  $" << i << " = slot " << Name(function.slots[i].type) << " ; "
+                << Interner::spelling(function.slots[i].name) << "\n";
+        }
+        const auto predecessors = function.Predecessors();
+        for (const BasicBlock& block : function.blocks) {
+            out << "bb" << block.id << ":";
+            if (!predecessors[block.id].empty()) {
+                out << " ; preds";
+                for (const BlockId predecessor : predecessors[block.id]) {
+                    out << " bb" << predecessor;
+                }
+            }
+            out << "\n";
+            for (const Instruction& instruction : block.instructions) {
+                out << "  " << Format(instruction) << "\n";
+            }
+        }
+        out << "}\n\n";
+    }
+};
+
+#endif //IRPRINTER_HPP
@@ -0,0 +1,221 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef VERIFIER_HPP
+#define VERIFIER_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Dominators.hpp"
+#include "Printer.hpp"
+
+// Checks the structural rules of the IR and throws std::runtime_error naming
+// the function and the offending instruction when one is broken:
+//  - every block ends in its only terminator and begins with its phis,
+//  - each phi has exactly one operand per predecessor,
+//  - operand counts, result types, slots and branch targets are in range,
+//  - every register is defined once, by an instruction or as a parameter,
+//    and its definition dominates its uses.
+class Verifier {
+    public:
+    static void
+    Verify(const IRModule& module, std::string_view when = "") {
+        for (const IRFunction& function : module.functions) {
+            Verifier(function, when).Run();
+        }
+    }
+
+    private:
+    static constexpr std::size_t Variadic = static_cast<std::size_t>(-1);
+
+    const IRFunction& function;
+    std::string_view when;
+    // Defining block and position of each register, counted from 1 so that
+    // parameters are defined at position 0 of the entry block.
+    std::vector<BlockId> defBlock;
+    std::vector<std::size_t> defIndex;
+
+    Verifier(const IRFunction& function, std::string_view when)
+        : function(function), when(when), defBlock(function.registers.size(), DominatorTree::None),
+          defIndex(function.registers.size(), 0) {}
+
+    [[noreturn]] void
+    Fail(const std::string& problem, const Instruction* instruction = nullptr) const {
+        std::string message = "IR verification failed";
+        if (!when.empty()) {
+            message += " " + std::string(when);
+        }
+        message += " in function '" + std::string(Interner::spelling(function.name)) + "': " + problem;
+        if (instruction) {
+            message += " at '" + IRPrinter::Format(*instruction) + "'";
+        }
+        throw std::runtime_error(message);
+    }
+
+    static std::size_t
+    OperandCount(Opcode op) {
+        switch (op) {
+            case Opcode::Add:
+            case Opcode::Sub:
+            case Opcode::Mul:
+            case Opcode::SDiv:
+            case Opcode::Shl:
+            case Opcode::AShr:
+            case Opcode::LShr:
+            case Opcode::MulHi:
+                return 2;
+            case Opcode::Neg:
+            case Opcode::Copy:
+            case Opcode::Store:
+            case Opcode::Ret:
+                return 1;
+            case Opcode::Load:
+            case Opcode::Br:
+                return 0;
+            case Opcode::Call:
+            case Opcode::Phi:
+                return Variadic;
+        }
+        return 0;
+    }
+
+    static bool
+    HasResult(Opcode op) {
+        return op != Opcode::Store && op != Opcode::Br && op != Opcode::Ret;
+    }
+
+    void
+    Run() {
+        if (function.blocks.empty()) {
+            Fail("no entry block");
+        }
+        for (const VReg parameter : function.parameters) {
+            if (parameter >= function.registers.size() || function.registers[parameter] != IRType::I64) {
+                Fail("parameter %" + std::to_string(parameter) + " is not an i64 register");
+            }
+            if (defBlock[parameter] != DominatorTree::None) {
+                Fail("%" + std::to_string(parameter) + " is defined more than once");
+            }
+            defBlock[parameter] = 0;
+        }
+        const auto predecessors = function.Predecessors();
+        for (const BasicBlock& block : function.blocks) {
+            CheckBlock(block, predecessors);
+        }
+
+        const DominatorTree dominators(function);
+        for (const BasicBlock& block : function.blocks) {
+            if (!dominators.isReachable(block.id)) {
+                continue;
+            }
+            for (std::size_t i = 0; i < block.instructions.size(); ++i) {
+                const Instruction& instruction = block.instructions[i];
+                for (std::size_t j = 0; j < instruction.operands.size(); ++j) {
+                    const Operand& operand = instruction.operands[j];
+                    if (!operand.isReg()) {
+                        continue;
+                    }
+                    // A phi operand is used at the end of its incoming block.
+                    const bool isPhi = instruction.op == Opcode::Phi;
+                    const BlockId useBlock = isPhi ? instruction.blocks[j] : block.id;
+                    const std::size_t useIndex = isPhi ? function.blocks[useBlock].instructions.size() : i;
+                    const BlockId definedIn = defBlock[operand.reg];
+                    if (definedIn == DominatorTree::None) {
+                        Fail("%" + std::to_string(operand.reg) + " is used but never defined", &instruction);
+                    }
+                    const bool dominated = definedIn == useBlock
+                                               ? defIndex[operand.reg] <= useIndex
+                                               : dominators.Dominates(definedIn, useBlock);
+                    if (!dominated) {
+                        Fail("%" + std::to_string(operand.reg) + " is used where its definition does not dominate", &instruction);
+                    }
+                }
+            }
+        }
+    }
+
+    void
+    CheckBlock(const BasicBlock& block, const std::vector<std::vector<BlockId>>& predecessors) {
+        if (block.id >= function.blocks.size() || &function.blocks[block.id] != &block) {
+            Fail("bb" + std::to_string(block.id) + " is not at index " + std::to_string(block.id));
+        }
+        if (!block.isTerminated()) {
+            Fail("bb" + std::to_string(block.id) + " does not end in a terminator");
+        }
+        bool seenNonPhi = false;
+        for (std::size_t i = 0; i < block.instructions.size(); ++i) {
+            const Instruction& instruction = block.instructions[i];
+            if (instruction.isTerminator() && i + 1 != block.instructions.size()) {
+                Fail("terminator in the middle of bb" + std::to_string(block.id), &instruction);
+            }
+            if (instruction.op == Opcode::Phi) {
+                if (seenNonPhi) {
+                    Fail("phi after the start of bb" + std::to_string(block.id), &instruction);
+                }
+                CheckPhi(block, instruction, predecessors[block.id]);
+            } else {
+                seenNonPhi = true;
+            }
+            CheckInstruction(instruction);
+
+            if (HasResult(instruction.op)) {
+                if (defBlock[instruction.result] != DominatorTree::None) {
+                    Fail("%" + std::to_string(instruction.result) + " is defined more than once", &instruction);
+                }
+                defBlock[instruction.result] = block.id;
+                defIndex[instruction.result] = i + 1;
+            }
+        }
+    }
+
+    void
+    CheckInstruction(const Instruction& instruction) {
+        const std::size_t expected = OperandCount(instruction.op);
+        if (expected != Variadic && instruction.operands.size() != expected) {
+            Fail("expected " + std::to_string(expected) + " operands", &instruction);
+        }
+        for (const Operand& operand : instruction.operands) {
+            if (operand.isReg() && operand.reg >= function.registers.size()) {
+                Fail("operand register out of range", &instruction);
+            }
+            if (operand.isReg() && function.registers[operand.reg] != IRType::I64) {
+                Fail("operand is not an i64", &instruction);
+            }
+        }
+        if (HasResult(instruction.op)) {
+            if (instruction.result >= function.registers.size()) {
+                Fail("result register out of range", &instruction);
+            }
+            if (function.registers[instruction.result] != IRType::I64) {
+                Fail("result is not an i64", &instruction);
+            }
+        } else if (instruction.result != NoVReg) {
+            Fail("instruction cannot have a result", &instruction);
+        }
+        if ((instruction.op == Opcode::Load || instruction.op == Opcode::Store) && instruction.slot >= function.slots.size()) {
+            Fail("slot out of range", &instruction);
+        }
+        if (instruction.op == Opcode::Call && instruction.callee == InvalidSymbol) {
+            Fail("call without a callee", &instruction);
+        }
+        if (instruction.op == Opcode::Br && (instruction.blocks.size() != 1 || instruction.blocks[0] >= function.blocks.size())) {
+            Fail("branch target out of range", &instruction);
+        }
+    }
+
+    void
+    CheckPhi(const BasicBlock& block, const Instruction& phi, const std::vector<BlockId>& predecessors) {
+        if (phi.operands.size() != phi.blocks.size() || phi.blocks.size() != predecessors.size()) {
+            Fail("phi needs one operand per predecessor of bb" + std::to_string(block.id), &phi);
+        }
+        for (const BlockId predecessor : predecessors) {
+            if (std::ranges::count(phi.blocks, predecessor) != 1) {
+                Fail("phi has no single operand for bb" + std::to_string(predecessor), &phi);
+            }
+        }
+    }
+};
+
+#endif //VERIFIER_HPP
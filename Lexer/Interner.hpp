@@ -0,0 +1,53 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Dense id of an interned identifier. Ids start at 0 and grow by one per
+// distinct spelling, so passes can index flat vectors with them.
+using SymbolId = std::uint32_t;
+inline constexpr SymbolId InvalidSymbol = std::numeric_limits<SymbolId>::max();
+
+// Process-wide identifier table. The lexer interns each identifier once;
+// everything after it compares and indexes by SymbolId. Not synchronized:
+// interning happens during lexing, which is single threaded. Once lexing is
+// done, spelling() may be called from any number of threads.
+class Interner {
+  public:
+  static SymbolId
+  intern(std::string_view text) {
+    if (const auto found = ids.find(text); found != ids.end()) {
+      return found->second;
+    }
+    const auto id = static_cast<SymbolId>(spellings.size());
+    const std::string& stored = spellings.emplace_back(text);
+    ids.emplace(stored, id);
+    return id;
+  }
+
+  [[nodiscard]] static std::string_view
+  spelling(SymbolId id) {
+    return spellings[id];
+  }
+
+  [[nodiscard]] static std::size_t
+  size() {
+    return spellings.size();
+  }
+
+  private:
+  // A deque never moves its elements, so the map's keys can view them.
+  inline static std::deque<std::string> spellings;
+  inline static std::unordered_map<std::string_view, SymbolId> ids;
+};
+
+#endif //INTERNER_HPP
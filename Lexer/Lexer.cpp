@@ -9,61 +9,83 @@
 #include <string_view>
 #include <stdexcept>
 #include <array>
-#include <fstream>
+#include <limits>
+#include <optional>
+#include <utility>
 #include <iostream>
+#include "MappedFile.hpp"
+#include "Scanner.hpp"
 #include "Token.hpp"
 
 
 
 class Lexer {
   public:
-  static constexpr std::array<std::string_view,3> keyWords = {"return", "ret","int"};
+  static constexpr std::array<std::pair<std::string_view, TokenKind>,7> keyWords = {{
+    {"return", TokenKind::TK_KW_RETURN},
+    {"ret", TokenKind::TK_KEYWORD},
+    {"int", TokenKind::TK_KW_INT},
+    {"class", TokenKind::TK_KW_CLASS},
+    {"namespace", TokenKind::TK_KW_NAMESPACE},
+    {"static", TokenKind::TK_KW_STATIC},
+    {"import", TokenKind::TK_KW_IMPORT},
+  }};
 
+  // Maps the file at path and scans it in place. Token text is a view into
+  // the mapping, so tokens must not outlive the lexer.
   explicit Lexer(const std::string& path) : path(path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
+    try {
+      file.emplace(path);
+    } catch (const std::runtime_error&) {
       std::cerr << "Failed to open file." << std::endl;
       throw std::runtime_error("Failed to open file.");
     }
-    input=std::move(file);
+    reset(file->view());
+  }
+
+  // Scans text owned by the caller; name is only used in diagnostics.
+  // firstLine numbers the first line of text, for text cut out of a file.
+  Lexer(std::string_view text, std::string name, int firstLine = 1) : firstLine(firstLine), path(std::move(name)) {
+    reset(text);
   }
 
   ~Lexer() {
-    if (input.is_open()) {
-      input.close();
-    }
-    std::cout << std::format("Processed {} lines in lexer for file {}\n ",lineCount,path);
+    std::cout << std::format("Processed {} lines in lexer for file {}\n ",lineCount - firstLine + 1,path);
   }
   Lexer(const Lexer&) = delete;
   Lexer& operator=(const Lexer&) = delete;
 
   Token
   getNextToken() {
-    char ch;
-    while (input.get(ch)) {
-      if (positionCount == 0) {
-        lineCount++;
-      }
-      positionCount++;
-      if('\n' == ch) {
-        positionCount = 0;
-        continue;
-      }
-      if (std::isspace(ch)) {
-        continue;
-      }
-      if (std::isdigit(ch)) {
-        return makeTokenFromInt(ch);
-      }
-      if (std::isalpha(ch)) {
-        return makeTokenFromText(ch);
-      }
-      if (std::ispunct(ch)) {
-        return makeTokenFromPunctuation(ch);
-      }
-      throw std::runtime_error("Unexpected character: " + std::string(1, ch));
+    cursor = Scanner::skipWhitespace(cursor, end, lineCount, lineStart);
+    if (cursor == end) {
+      return Token{TokenKind::TK_EOF, {}};
+    }
+    const char ch = *cursor;
+    if (Scanner::isDigit(ch)) {
+      return makeTokenFromInt();
+    }
+    if (Scanner::isAlpha(ch)) {
+      return makeTokenFromText();
     }
-    return Token{TokenKind::TK_EOF, ""};
+    if (std::ispunct(static_cast<unsigned char>(ch))) {
+      return makeTokenFromPunctuation();
+    }
+    ++cursor;
+    // A lone byte of a multi-byte character is not text on its own.
+    const auto byte = static_cast<unsigned char>(ch);
+    throw std::runtime_error(byte >= 0x20 && byte < 0x7F ? "Unexpected character: " + std::string(1, ch)
+                                                         : std::format("Unexpected character: 0x{:02X}", byte));
+  }
+
+  [[nodiscard]] const std::string&
+  getPath() const {
+    return path;
+  }
+
+  [[nodiscard]] std::string_view
+  getSource() const {
+    return source;
   }
 
   [[nodiscard]] int
@@ -72,70 +94,103 @@ class Lexer {
   }
   [[nodiscard]] int
   getCurrentPosition() const {
-    return positionCount;
+    return static_cast<int>(cursor - lineStart);
+  }
+
+  // Integer literals may contain whitespace between digits ("12 34" is 1234).
+  static int
+  parseIntLiteral(std::string_view text) {
+    long long value = 0;
+    for (const char ch : text) {
+      if (Scanner::isDigit(ch)) {
+        value = value * 10 + (ch - '0');
+        if (value > std::numeric_limits<int>::max()) {
+          throw std::runtime_error("Integer literal out of range: " + std::string(text));
+        }
+      }
+    }
+    return static_cast<int>(value);
   }
 
   private:
-  std::ifstream input;
+  std::optional<MappedFile> file;
+  std::string_view source;
+  const char* cursor = nullptr;
+  const char* end = nullptr;
+  const char* lineStart = nullptr;
   int lineCount=0;
-  int positionCount=0;
+  const int firstLine = 1;
   const std::string path;
 
+  void
+  reset(std::string_view text) {
+    source = text;
+    cursor = text.data();
+    end = cursor + text.size();
+    lineStart = cursor;
+    lineCount = text.empty() ? firstLine - 1 : firstLine;
+  }
+
   Token
-  makeTokenFromInt(char firstChar) {
-    std::string value(1, firstChar);
-    char ch;
-    while (input.get(ch) && (std::isdigit(ch) || std::isspace(ch))) {
-      if (!std::isspace(ch)) {
-        value += ch;
+  makeTokenFromInt() {
+    const char* start = cursor;
+    while (true) {
+      cursor = Scanner::skipDigits(cursor, end);
+      // Whitespace only continues the literal when another digit follows it.
+      int nextLine = lineCount;
+      const char* nextLineStart = lineStart;
+      const char* next = Scanner::skipWhitespace(cursor, end, nextLine, nextLineStart);
+      if (next == cursor || next == end || !Scanner::isDigit(*next)) {
+        break;
       }
+      cursor = next;
+      lineCount = nextLine;
+      lineStart = nextLineStart;
     }
-    if (input) {
-      input.putback(ch);
-    }
-    return Token{TokenKind::TK_INT, value};
+    return Token{TokenKind::TK_INT, {start, static_cast<size_t>(cursor - start)}};
   }
 
   Token
-  makeTokenFromText(char firstChar) {
-    std::string value(1, firstChar);
-    char ch;
-    while (input.get(ch) && (std::isalnum(ch) || ch == '_')) {
-      value += ch;
-    }
-    if (input) {
-      input.putback(ch);
-    }
-    if (std::ranges::find(keyWords, value) != keyWords.end()) {
-      return Token{TokenKind::TK_KEYWORD, value};
+  makeTokenFromText() {
+    const char* start = cursor;
+    cursor = Scanner::skipIdentifier(cursor + 1, end);
+    const std::string_view value(start, static_cast<size_t>(cursor - start));
+    const SymbolId symbol = Interner::intern(value);
+    for (const auto& [keyword, kind] : keyWords) {
+      if (keyword == value) {
+        return Token{kind, value, symbol};
+      }
     }
-    return Token{TokenKind::TK_IDENTIFIER, value};
+    return Token{TokenKind::TK_IDENTIFIER, value, symbol};
   }
 
   Token
-  makeTokenFromPunctuation(char firstChar) {
+  makeTokenFromPunctuation() {
     using enum TokenKind;
-    switch (firstChar) {
-      case '+': return Token{TK_PLUS, "+"};
-      case '-': return Token{TK_MINUS, "-"};
-      case '/': return Token{TK_SLASH, "/"};
-      case '*': return Token{TK_ASTERISK, "*"};
+    const char* start = cursor++;
+    auto token = [start, this](TokenKind kind) {
+      return Token{kind, {start, static_cast<size_t>(cursor - start)}};
+    };
+    switch (*start) {
+      case '+': return token(TK_PLUS);
+      case '-': return token(TK_MINUS);
+      case '/': return token(TK_SLASH);
+      case '*': return token(TK_ASTERISK);
       case ':': {
-        char next;
-        if (input.get(next)) {
-          if (next == ':') return Token{TK_COLONCOLON, "::"};
-          if (next == '=') return Token{TK_COLONEQUAL, ":="};
-          input.putback(next);
+        if (cursor != end) {
+          if (*cursor == ':') { ++cursor; return token(TK_COLONCOLON); }
+          if (*cursor == '=') { ++cursor; return token(TK_COLONEQUAL); }
         }
-        return Token{TK_COLON, ":"};
+        return token(TK_COLON);
       }
-      case '=': return Token{TK_EQUAL, "="};
-      case ';': return Token{TK_SEMICOLON, ";"};
-      case '{': return Token{TK_OPEN_BRACE, "{"};
-      case '}': return Token{TK_CLOSE_BRACE, "}"};
-      case '(': return Token{TK_OPEN_PAREN, "("};
-      case ')': return Token{TK_CLOSE_PAREN, ")"};
-      case ',': return Token{TK_COMMA, ","};
+      case '=': return token(TK_EQUAL);
+      case ';': return token(TK_SEMICOLON);
+      case '{': return token(TK_OPEN_BRACE);
+      case '}': return token(TK_CLOSE_BRACE);
+      case '(': return token(TK_OPEN_PAREN);
+      case ')': return token(TK_CLOSE_PAREN);
+      case ',': return token(TK_COMMA);
+      case '.': return token(TK_DOT);
       default: throw std::runtime_error("Invalid punctuation");
     }
   }
@@ -0,0 +1,86 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file. On POSIX hosts the file is mmapped so the
+// lexer can scan it in place; elsewhere it is read into memory once.
+class MappedFile {
+  public:
+  explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+      throw std::runtime_error("Failed to open file: " + path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+    data = buffer.data();
+    size = buffer.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open file: " + path);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size > 0) {
+      void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Failed to map file: " + path);
+      }
+      ::madvise(mapping, size, MADV_SEQUENTIAL);
+      data = static_cast<const char*>(mapping);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+#endif
+  }
+
+  ~MappedFile() {
+#ifndef _WIN32
+    if (size > 0) {
+      ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] std::string_view
+  view() const {
+    return {data, size};
+  }
+
+  private:
+  const char* data = "";
+  std::size_t size = 0;
+#ifdef _WIN32
+  std::string buffer;
+#endif
+};
+
+#endif //MAPPEDFILE_HPP
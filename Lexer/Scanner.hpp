@@ -0,0 +1,375 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CEJ_SCANNER_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__)
+#define CEJ_SCANNER_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Bulk byte classification for the lexer. Each routine returns the first
+// position in [p, end) that does not belong to the run it skips. The vector
+// paths look at 16 or 32 bytes per step and never read past end; the tail is
+// finished by the scalar loop, which is also the reference definition.
+//
+// Most runs in source are a few bytes long: one space, an indent, a short
+// name. Setting up a vector compare for those costs more than it saves, so
+// the first ShortRun bytes are tested inline and only longer runs go to the
+// dispatched routine. LexerBenchmark measures the levels against each other
+// and against the original per-byte lexer.
+class Scanner {
+  public:
+  enum class Level { Scalar, SSE2, AVX2, NEON };
+
+  static constexpr int ShortRun = 4;
+
+  // Skips ' ', '\t', '\n', '\v', '\f' and '\r'. Every '\n' crossed bumps
+  // lineCount and moves lineStart to the byte after it.
+  static const char*
+  skipWhitespace(const char* p, const char* end, int& lineCount, const char*& lineStart) {
+    for (const char* shortEnd = shortRunEnd(p, end); p != shortEnd; ++p) {
+      if (!isSpace(*p)) {
+        return p;
+      }
+      if ('\n' == *p) {
+        lineCount++;
+        lineStart = p + 1;
+      }
+    }
+    return p == end ? p : active().whitespace(p, end, lineCount, lineStart);
+  }
+
+  // Skips [A-Za-z0-9_].
+  static const char*
+  skipIdentifier(const char* p, const char* end) {
+    for (const char* shortEnd = shortRunEnd(p, end); p != shortEnd; ++p) {
+      if (!isIdentifier(*p)) {
+        return p;
+      }
+    }
+    return p == end ? p : active().identifier(p, end);
+  }
+
+  // Skips [0-9].
+  static const char*
+  skipDigits(const char* p, const char* end) {
+    for (const char* shortEnd = shortRunEnd(p, end); p != shortEnd; ++p) {
+      if (!isDigit(*p)) {
+        return p;
+      }
+    }
+    return p == end ? p : active().digits(p, end);
+  }
+
+  [[nodiscard]] static Level
+  level() {
+    return active().level;
+  }
+
+  // Best level the host supports.
+  [[nodiscard]] static Level
+  bestLevel() {
+#if defined(CEJ_SCANNER_X86)
+    return __builtin_cpu_supports("avx2") ? Level::AVX2 : Level::SSE2;
+#elif defined(CEJ_SCANNER_NEON)
+    return Level::NEON;
+#else
+    return Level::Scalar;
+#endif
+  }
+
+  // Level used until setLevel is called. Unoptimized builds do not inline
+  // the intrinsics, which makes every vector path slower than the scalar
+  // loop, so they only use the vector paths when optimizing.
+  [[nodiscard]] static Level
+  defaultLevel() {
+#if defined(__OPTIMIZE__)
+    return bestLevel();
+#else
+    return Level::Scalar;
+#endif
+  }
+
+  // Overrides the dispatch, e.g. to benchmark the scalar path. Levels the
+  // host cannot run fall back to bestLevel().
+  static void
+  setLevel(Level level) {
+    active() = table(level);
+  }
+
+  static constexpr bool
+  isSpace(char ch) {
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+  }
+  static constexpr bool
+  isDigit(char ch) {
+    return ch >= '0' && ch <= '9';
+  }
+  static constexpr bool
+  isAlpha(char ch) {
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+  }
+  static constexpr bool
+  isIdentifier(char ch) {
+    return isAlpha(ch) || isDigit(ch) || ch == '_';
+  }
+
+  private:
+  struct Dispatch {
+    Level level;
+    const char* (*whitespace)(const char*, const char*, int&, const char*&);
+    const char* (*identifier)(const char*, const char*);
+    const char* (*digits)(const char*, const char*);
+  };
+
+  static Dispatch&
+  active() {
+    static Dispatch dispatch = table(defaultLevel());
+    return dispatch;
+  }
+
+  static const char*
+  shortRunEnd(const char* p, const char* end) {
+    return end - p > ShortRun ? p + ShortRun : end;
+  }
+
+  static Dispatch
+  table(Level level) {
+    switch (level) {
+#if defined(CEJ_SCANNER_X86)
+      case Level::AVX2:
+        if (__builtin_cpu_supports("avx2")) {
+          return {Level::AVX2, whitespaceAVX2, identifierAVX2, digitsAVX2};
+        }
+        return table(bestLevel());
+      case Level::SSE2:
+        return {Level::SSE2, whitespaceSSE2, identifierSSE2, digitsSSE2};
+#elif defined(CEJ_SCANNER_NEON)
+      case Level::NEON:
+        return {Level::NEON, whitespaceNEON, identifierNEON, digitsNEON};
+#endif
+      case Level::Scalar:
+        return {Level::Scalar, whitespaceScalar, identifierScalar, digitsScalar};
+      default:
+        return table(bestLevel());
+    }
+  }
+
+  // Accounts for the newlines in the first bytes of a block; bit i of mask
+  // is set when block[i] is '\n'.
+  static void
+  countLines(const char* block, std::uint64_t mask, int& lineCount, const char*& lineStart) {
+    if (mask != 0) {
+      lineCount += __builtin_popcountll(mask);
+      lineStart = block + (63 - __builtin_clzll(mask)) + 1;
+    }
+  }
+
+  static const char*
+  whitespaceScalar(const char* p, const char* end, int& lineCount, const char*& lineStart) {
+    for (; p != end && isSpace(*p); ++p) {
+      if ('\n' == *p) {
+        lineCount++;
+        lineStart = p + 1;
+      }
+    }
+    return p;
+  }
+  static const char*
+  identifierScalar(const char* p, const char* end) {
+    while (p != end && isIdentifier(*p)) {
+      ++p;
+    }
+    return p;
+  }
+  static const char*
+  digitsScalar(const char* p, const char* end) {
+    while (p != end && isDigit(*p)) {
+      ++p;
+    }
+    return p;
+  }
+
+#if defined(CEJ_SCANNER_X86)
+  // Unsigned range test lo <= c <= lo + span, built from SSE2's unsigned min.
+  static __m128i
+  inRange(__m128i c, char lo, char span) {
+    const __m128i shifted = _mm_sub_epi8(c, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(span)), shifted);
+  }
+  static __m128i
+  identifierMask(__m128i c) {
+    const __m128i letters = inRange(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 25);
+    const __m128i underscore = _mm_cmpeq_epi8(c, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(letters, inRange(c, '0', 9)), underscore);
+  }
+
+  static const char*
+  whitespaceSSE2(const char* p, const char* end, int& lineCount, const char*& lineStart) {
+    while (end - p >= 16) {
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), inRange(c, '\t', 4));
+      const auto spaceMask = static_cast<std::uint32_t>(_mm_movemask_epi8(space));
+      auto newlineMask = static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('\n'))));
+      if (spaceMask != 0xFFFF) {
+        const int stop = __builtin_ctz(~spaceMask);
+        countLines(p, newlineMask & ((1ULL << stop) - 1), lineCount, lineStart);
+        return p + stop;
+      }
+      countLines(p, newlineMask, lineCount, lineStart);
+      p += 16;
+    }
+    return whitespaceScalar(p, end, lineCount, lineStart);
+  }
+  static const char*
+  identifierSSE2(const char* p, const char* end) {
+    while (end - p >= 16) {
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(identifierMask(c)));
+      if (mask != 0xFFFF) {
+        return p + __builtin_ctz(~mask);
+      }
+      p += 16;
+    }
+    return identifierScalar(p, end);
+  }
+  static const char*
+  digitsSSE2(const char* p, const char* end) {
+    while (end - p >= 16) {
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(inRange(c, '0', 9)));
+      if (mask != 0xFFFF) {
+        return p + __builtin_ctz(~mask);
+      }
+      p += 16;
+    }
+    return digitsScalar(p, end);
+  }
+
+  __attribute__((target("avx2"))) static __m256i
+  inRange256(__m256i c, char lo, char span) {
+    const __m256i shifted = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(span)), shifted);
+  }
+
+  __attribute__((target("avx2"))) static const char*
+  whitespaceAVX2(const char* p, const char* end, int& lineCount, const char*& lineStart) {
+    while (end - p >= 32) {
+      const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')), inRange256(c, '\t', 4));
+      const auto spaceMask = static_cast<std::uint32_t>(_mm256_movemask_epi8(space));
+      const auto newlineMask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n'))));
+      if (spaceMask != 0xFFFFFFFFu) {
+        const int stop = __builtin_ctz(~spaceMask);
+        countLines(p, newlineMask & ((1ULL << stop) - 1), lineCount, lineStart);
+        return p + stop;
+      }
+      countLines(p, newlineMask, lineCount, lineStart);
+      p += 32;
+    }
+    return whitespaceSSE2(p, end, lineCount, lineStart);
+  }
+  __attribute__((target("avx2"))) static const char*
+  identifierAVX2(const char* p, const char* end) {
+    while (end - p >= 32) {
+      const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      const __m256i letters = inRange256(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 25);
+      const __m256i underscore = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_'));
+      const __m256i ident = _mm256_or_si256(_mm256_or_si256(letters, inRange256(c, '0', 9)), underscore);
+      const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(ident));
+      if (mask != 0xFFFFFFFFu) {
+        return p + __builtin_ctz(~mask);
+      }
+      p += 32;
+    }
+    return identifierSSE2(p, end);
+  }
+  __attribute__((target("avx2"))) static const char*
+  digitsAVX2(const char* p, const char* end) {
+    while (end - p >= 32) {
+      const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(inRange256(c, '0', 9)));
+      if (mask != 0xFFFFFFFFu) {
+        return p + __builtin_ctz(~mask);
+      }
+      p += 32;
+    }
+    return digitsSSE2(p, end);
+  }
+#endif
+
+#if defined(CEJ_SCANNER_NEON)
+  // NEON has no movemask; narrowing shifts give four mask bits per byte.
+  static std::uint64_t
+  nibbleMask(uint8x16_t matches) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+  }
+  // Converts a nibble mask (bit 4*i set for byte i) to one bit per byte.
+  static std::uint64_t
+  compactNibbles(std::uint64_t nibbles) {
+    std::uint64_t bits = 0;
+    for (nibbles &= 0x1111111111111111ULL; nibbles != 0; nibbles &= nibbles - 1) {
+      bits |= 1ULL << (__builtin_ctzll(nibbles) / 4);
+    }
+    return bits;
+  }
+  static uint8x16_t
+  inRangeNEON(uint8x16_t c, std::uint8_t lo, std::uint8_t span) {
+    return vcleq_u8(vsubq_u8(c, vdupq_n_u8(lo)), vdupq_n_u8(span));
+  }
+
+  static const char*
+  whitespaceNEON(const char* p, const char* end, int& lineCount, const char*& lineStart) {
+    while (end - p >= 16) {
+      const uint8x16_t c = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+      const uint8x16_t space = vorrq_u8(vceqq_u8(c, vdupq_n_u8(' ')), inRangeNEON(c, '\t', 4));
+      const std::uint64_t spaceMask = nibbleMask(space);
+      const std::uint64_t newlineMask = compactNibbles(nibbleMask(vceqq_u8(c, vdupq_n_u8('\n'))));
+      if (spaceMask != ~0ULL) {
+        const int stop = __builtin_ctzll(~spaceMask) / 4;
+        countLines(p, newlineMask & ((1ULL << stop) - 1), lineCount, lineStart);
+        return p + stop;
+      }
+      countLines(p, newlineMask, lineCount, lineStart);
+      p += 16;
+    }
+    return whitespaceScalar(p, end, lineCount, lineStart);
+  }
+  static const char*
+  identifierNEON(const char* p, const char* end) {
+    while (end - p >= 16) {
+      const uint8x16_t c = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+      const uint8x16_t letters = inRangeNEON(vorrq_u8(c, vdupq_n_u8(0x20)), 'a', 25);
+      const uint8x16_t ident = vorrq_u8(vorrq_u8(letters, inRangeNEON(c, '0', 9)), vceqq_u8(c, vdupq_n_u8('_')));
+      const std::uint64_t mask = nibbleMask(ident);
+      if (mask != ~0ULL) {
+        return p + __builtin_ctzll(~mask) / 4;
+      }
+      p += 16;
+    }
+    return identifierScalar(p, end);
+  }
+  static const char*
+  digitsNEON(const char* p, const char* end) {
+    while (end - p >= 16) {
+      const uint8x16_t c = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+      const std::uint64_t mask = nibbleMask(inRangeNEON(c, '0', 9));
+      if (mask != ~0ULL) {
+        return p + __builtin_ctzll(~mask) / 4;
+      }
+      p += 16;
+    }
+    return digitsScalar(p, end);
+  }
+#endif
+};
+
+#endif //SCANNER_HPP
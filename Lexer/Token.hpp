@@ -4,10 +4,19 @@
 #ifndef TOKEN_HPP
 #define TOKEN_HPP
 
+#include <string_view>
+#include "Interner.hpp"
+
 enum class TokenKind {
   TK_EOF,
   TK_INT,
   TK_KEYWORD,
+  TK_KW_RETURN,
+  TK_KW_INT,
+  TK_KW_CLASS,
+  TK_KW_NAMESPACE,
+  TK_KW_STATIC,
+  TK_KW_IMPORT,
   TK_IDENTIFIER,
   TK_PLUS,
   TK_MINUS,
@@ -22,12 +31,48 @@ enum class TokenKind {
   TK_CLOSE_BRACE,
   TK_OPEN_PAREN,
   TK_CLOSE_PAREN,
-  TK_COMMA
+  TK_COMMA,
+  TK_DOT
 };
 
+// Fixed spelling of a token kind, for diagnostics.
+constexpr std::string_view
+tokenKindSpelling(TokenKind kind) {
+  using enum TokenKind;
+  switch (kind) {
+    case TK_EOF: return "<EOF>";
+    case TK_INT: return "integer literal";
+    case TK_KEYWORD: return "keyword";
+    case TK_KW_RETURN: return "return";
+    case TK_KW_INT: return "int";
+    case TK_KW_CLASS: return "class";
+    case TK_KW_NAMESPACE: return "namespace";
+    case TK_KW_STATIC: return "static";
+    case TK_KW_IMPORT: return "import";
+    case TK_IDENTIFIER: return "identifier";
+    case TK_PLUS: return "+";
+    case TK_MINUS: return "-";
+    case TK_SLASH: return "/";
+    case TK_ASTERISK: return "*";
+    case TK_COLON: return ":";
+    case TK_COLONCOLON: return "::";
+    case TK_EQUAL: return "=";
+    case TK_COLONEQUAL: return ":=";
+    case TK_SEMICOLON: return ";";
+    case TK_OPEN_BRACE: return "{";
+    case TK_CLOSE_BRACE: return "}";
+    case TK_OPEN_PAREN: return "(";
+    case TK_CLOSE_PAREN: return ")";
+    case TK_COMMA: return ",";
+    case TK_DOT: return ".";
+  }
+  return "<unknown>";
+}
+
 struct Token {
   TokenKind kind{};
-  std::string raw_val;
+  std::string_view raw_val; // View into the lexer's source buffer
+  SymbolId symbol = InvalidSymbol; // Set for identifiers and keywords
 };
 
 #endif //TOKEN_HPP
\ No newline at end of file
@@ -0,0 +1,85 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef TOKENBUFFER_HPP
+#define TOKENBUFFER_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Lexer.cpp"
+
+// Whole-file token stream stored as parallel arrays, so the parser can look
+// ahead by index without copying tokens. Text is recovered from the source
+// the offsets point into; the last entry is always TK_EOF.
+struct TokenBuffer {
+  std::string_view source;
+  std::vector<TokenKind> kinds;
+  std::vector<std::uint32_t> offsets;
+  std::vector<std::uint32_t> lengths;
+  std::vector<std::uint32_t> lines;
+  std::vector<SymbolId> symbols;
+
+  static TokenBuffer
+  Tokenize(Lexer& lexer) {
+    TokenBuffer buffer;
+    buffer.source = lexer.getSource();
+    // Roughly one token per four bytes of typical source.
+    buffer.reserve(buffer.source.size() / 4 + 1);
+    while (true) {
+      const Token token = lexer.getNextToken();
+      const auto offset = token.kind == TokenKind::TK_EOF
+        ? buffer.source.size()
+        : static_cast<std::size_t>(token.raw_val.data() - buffer.source.data());
+      buffer.kinds.push_back(token.kind);
+      buffer.offsets.push_back(static_cast<std::uint32_t>(offset));
+      buffer.lengths.push_back(static_cast<std::uint32_t>(token.raw_val.size()));
+      buffer.lines.push_back(static_cast<std::uint32_t>(lexer.getCurrentLine()));
+      buffer.symbols.push_back(token.symbol);
+      if (token.kind == TokenKind::TK_EOF) {
+        return buffer;
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t
+  size() const {
+    return kinds.size();
+  }
+
+  [[nodiscard]] std::string_view
+  text(std::size_t index) const {
+    return source.substr(offsets[index], lengths[index]);
+  }
+
+  // 0-based column of the token's first character.
+  [[nodiscard]] int
+  column(std::size_t index) const {
+    return columnOf(offsets[index]);
+  }
+
+  // 0-based column just past the token's last character.
+  [[nodiscard]] int
+  endColumn(std::size_t index) const {
+    return columnOf(offsets[index] + lengths[index]);
+  }
+
+  private:
+  [[nodiscard]] int
+  columnOf(std::size_t offset) const {
+    const std::size_t newline = offset == 0 ? std::string_view::npos : source.rfind('\n', offset - 1);
+    return static_cast<int>(newline == std::string_view::npos ? offset : offset - newline - 1);
+  }
+
+  void
+  reserve(std::size_t count) {
+    kinds.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    lines.reserve(count);
+    symbols.reserve(count);
+  }
+};
+
+#endif //TOKENBUFFER_HPP
@@ -0,0 +1,129 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef IMPORTRESOLVER_HPP
+#define IMPORTRESOLVER_HPP
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ModuleInterface.hpp"
+
+// Loads the interface file of every top-level `import name;` from the search
+// directories and checks each call against the signatures of the functions
+// defined in the unit or imported into it. Calls to unknown functions are
+// left for the linker, as before.
+class ImportResolver {
+  public:
+  explicit ImportResolver(std::vector<std::filesystem::path> searchDirs) : searchDirs(std::move(searchDirs)) {}
+
+  void
+  Resolve(const CompilationUnit& unit) {
+    functions.clear();
+    for (const ASTNode* node : unit.nodes) {
+      if (auto function = node->as<FunctionDef>()) {
+        functions[function->name] = {InvalidSymbol, static_cast<std::uint32_t>(function->parameters.size())};
+      }
+    }
+    for (const ASTNode* node : unit.nodes) {
+      if (auto importStmt = node->as<Import>()) {
+        Load(importStmt->module);
+      }
+    }
+    CheckCalls(unit);
+  }
+
+  // First <module>.cejm found in the search directories, or an empty path.
+  [[nodiscard]] std::filesystem::path
+  Find(std::string_view module) const {
+    const std::string fileName = std::string(module) + std::string(ModuleInterface::Extension);
+    for (const auto& dir : searchDirs) {
+      if (std::filesystem::path candidate = dir / fileName; std::filesystem::exists(candidate)) {
+        return candidate;
+      }
+    }
+    return {};
+  }
+
+  private:
+  struct Callee {
+    SymbolId module; // InvalidSymbol when defined in the unit itself
+    std::uint32_t parameterCount;
+  };
+
+  std::vector<std::filesystem::path> searchDirs;
+  std::unordered_map<SymbolId, Callee> functions;
+
+  void
+  Load(SymbolId module) {
+    const std::string_view moduleName = Interner::spelling(module);
+    const std::filesystem::path path = Find(moduleName);
+    if (path.empty()) {
+      throw std::runtime_error("Module '" + std::string(moduleName) + "' not found in include_dirs");
+    }
+    const ModuleInterface moduleInterface(path.string());
+    for (std::size_t i = 0; i < moduleInterface.size(); ++i) {
+      const ModuleInterface::Signature signature = moduleInterface.signature(i);
+      const SymbolId name = Interner::intern(signature.name);
+      const auto [existing, inserted] = functions.try_emplace(name, Callee{module, signature.parameterCount});
+      if (!inserted && existing->second.module != module) {
+        const std::string where = existing->second.module == InvalidSymbol
+          ? "this unit" : "module '" + std::string(Interner::spelling(existing->second.module)) + "'";
+        throw std::runtime_error("Function '" + std::string(signature.name) + "' imported from module '" + std::string(moduleName) + "' is already defined in " + where);
+      }
+    }
+  }
+
+  // Walks every node with an explicit stack and checks call arities.
+  void
+  CheckCalls(const CompilationUnit& unit) const {
+    std::vector<const ASTNode*> pending(unit.nodes.begin(), unit.nodes.end());
+    auto pushAll = [&](auto children) { pending.insert(pending.end(), children.begin(), children.end()); };
+    while (!pending.empty()) {
+      const ASTNode* node = pending.back();
+      pending.pop_back();
+      switch (node->kind) {
+        case NodeKind::FunctionDef: pushAll(node->as<FunctionDef>()->statements); break;
+        case NodeKind::Return: pending.push_back(node->as<Return>()->expression); break;
+        case NodeKind::Declare:
+          if (const Exp* initializer = node->as<Declare>()->initializer) {
+            pending.push_back(initializer);
+          }
+          break;
+        case NodeKind::ExpStatement: pending.push_back(node->as<ExpStatement>()->expression); break;
+        case NodeKind::ClassDef: pushAll(node->as<ClassDef>()->members); break;
+        case NodeKind::NamespaceDef: pushAll(node->as<NamespaceDef>()->statements); break;
+        case NodeKind::Assign: pending.push_back(node->as<Assign>()->value); break;
+        case NodeKind::ObjectCreation: pushAll(node->as<ObjectCreation>()->arguments); break;
+        case NodeKind::MemberAccess: pending.push_back(node->as<MemberAccess>()->object); break;
+        case NodeKind::BinOp:
+          pending.push_back(node->as<BinOp>()->lhs);
+          pending.push_back(node->as<BinOp>()->rhs);
+          break;
+        case NodeKind::UnOp: pending.push_back(node->as<UnOp>()->operand); break;
+        case NodeKind::FunctionCall: {
+          auto call = node->as<FunctionCall>();
+          CheckCall(call);
+          pushAll(call->arguments);
+          break;
+        }
+        default: break;
+      }
+    }
+  }
+
+  void
+  CheckCall(const FunctionCall* call) const {
+    const auto found = functions.find(call->name);
+    if (found == functions.end() || found->second.parameterCount == call->arguments.size()) {
+      return;
+    }
+    throw std::runtime_error("Function '" + std::string(Interner::spelling(call->name)) + "' takes " +
+      std::to_string(found->second.parameterCount) + " arguments but " + std::to_string(call->arguments.size()) + " were given");
+  }
+};
+
+#endif //IMPORTRESOLVER_HPP
@@ -0,0 +1,125 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef MODULEINTERFACE_HPP
+#define MODULEINTERFACE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Lexer/MappedFile.hpp"
+#include "../Parser/ParserTypes.hpp"
+
+// Binary interface of one compiled source, written next to its .s file as
+// <stem>.cejm. Importing units map it and read the exported signatures in
+// place instead of lexing and parsing the dependency's source.
+//
+// Layout, native byte order, every field a uint32:
+//   header:    magic "CEJM", version, function count, string table size
+//   functions: name offset, name length, return type offset,
+//              return type length, parameter count
+//   string table: the spellings the records point into
+class ModuleInterface {
+  public:
+  static constexpr std::string_view Extension = ".cejm";
+  static constexpr std::uint32_t Version = 1;
+
+  struct Signature {
+    std::string_view name;
+    std::string_view returnType;
+    std::uint32_t parameterCount;
+  };
+
+  // Writes the signature of every top-level function of unit to path.
+  static void
+  Write(const std::filesystem::path& path, const CompilationUnit& unit) {
+    std::vector<std::uint32_t> records;
+    std::string strings;
+    auto addString = [&](SymbolId symbol) {
+      const std::string_view spelling = Interner::spelling(symbol);
+      records.push_back(static_cast<std::uint32_t>(strings.size()));
+      records.push_back(static_cast<std::uint32_t>(spelling.size()));
+      strings += spelling;
+    };
+    std::uint32_t count = 0;
+    for (const ASTNode* node : unit.nodes) {
+      if (auto function = node->as<FunctionDef>()) {
+        addString(function->name);
+        addString(function->returnType);
+        records.push_back(static_cast<std::uint32_t>(function->parameters.size()));
+        count++;
+      }
+    }
+
+    const std::array<std::uint32_t, HeaderWords> header = {Magic, Version, count, static_cast<std::uint32_t>(strings.size())};
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      throw std::runtime_error("Failed to write module interface: " + path.string());
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(std::uint32_t)));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+  }
+
+  // Maps the interface at path and validates its header and bounds.
+  explicit ModuleInterface(const std::string& path) : file(path), bytes(file.view()) {
+    if (bytes.size() < HeaderWords * sizeof(std::uint32_t) || Word(0) != Magic) {
+      throw std::runtime_error("Not a module interface: " + path);
+    }
+    if (Word(1) != Version) {
+      throw std::runtime_error("Module interface " + path + " has version " + std::to_string(Word(1)) + ", expected " + std::to_string(Version));
+    }
+    count = Word(2);
+    const std::size_t stringsOffset = (HeaderWords + std::size_t{count} * RecordWords) * sizeof(std::uint32_t);
+    if (stringsOffset + Word(3) != bytes.size()) {
+      throw std::runtime_error("Truncated module interface: " + path);
+    }
+    strings = bytes.substr(stringsOffset);
+  }
+
+  [[nodiscard]] std::size_t
+  size() const {
+    return count;
+  }
+
+  // Views point into the mapping and live as long as this object.
+  [[nodiscard]] Signature
+  signature(std::size_t index) const {
+    const std::size_t record = HeaderWords + index * RecordWords;
+    return {String(Word(record), Word(record + 1)), String(Word(record + 2), Word(record + 3)), Word(record + 4)};
+  }
+
+  private:
+  static constexpr std::uint32_t Magic = 0x4D4A4543; // "CEJM" read as a little-endian word
+  static constexpr std::size_t HeaderWords = 4;
+  static constexpr std::size_t RecordWords = 5;
+
+  MappedFile file;
+  std::string_view bytes;
+  std::string_view strings;
+  std::uint32_t count = 0;
+
+  [[nodiscard]] std::uint32_t
+  Word(std::size_t index) const {
+    std::uint32_t word;
+    std::memcpy(&word, bytes.data() + index * sizeof(std::uint32_t), sizeof(word));
+    return word;
+  }
+
+  [[nodiscard]] std::string_view
+  String(std::uint32_t offset, std::uint32_t length) const {
+    if (std::size_t{offset} + length > strings.size()) {
+      throw std::runtime_error("Corrupt module interface string table");
+    }
+    return strings.substr(offset, length);
+  }
+};
+
+#endif //MODULEINTERFACE_HPP
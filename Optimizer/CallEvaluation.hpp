@@ -0,0 +1,94 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef CALLEVALUATION_HPP
+#define CALLEVALUATION_HPP
+
+#include <algorithm>
+#include <map>
+#include "../IR/Effects.hpp"
+#include "../IR/Interpreter.hpp"
+#include "../IR/PassManager.hpp"
+
+// Replaces calls to pure functions whose arguments are all constants with
+// the value they return, found by running the callee in the Interpreter.
+// Calls that exceed its limits or divide by zero are left to run as usual.
+// Results are remembered per callee and arguments, so each distinct call is
+// evaluated once.
+class CallEvaluation : public Pass {
+    public:
+    // A call that was replaced by its result.
+    struct Folded {
+        SymbolId caller;
+        SymbolId callee;
+        std::int64_t value;
+    };
+
+    explicit CallEvaluation(Interpreter::Limits limits, std::vector<Folded>* folded = nullptr)
+        : limits(limits), folded(folded) {}
+
+    [[nodiscard]] std::string_view Name() const override { return "evaluate-calls"; }
+
+    bool
+    Run(IRModule& module) override {
+        const CallGraph graph(module);
+        const EffectAnalysis effects(module, graph);
+        const Interpreter interpreter(module, limits);
+        std::map<std::pair<SymbolId, std::vector<std::int64_t>>, std::optional<std::int64_t>> results;
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            // Evaluate first and rewrite after, as the interpreter may be
+            // running this very function.
+            std::vector<std::optional<std::int64_t>> replacement(function.registers.size());
+            std::vector<std::vector<bool>> evaluated(function.blocks.size());
+            for (const BasicBlock& block : function.blocks) {
+                evaluated[block.id].resize(block.instructions.size(), false);
+                for (std::size_t i = 0; i < block.instructions.size(); ++i) {
+                    const Instruction& instruction = block.instructions[i];
+                    if (instruction.op != Opcode::Call || effects.Of(instruction.callee) != Effect::Pure ||
+                        !std::ranges::all_of(instruction.operands, &Operand::isImm)) {
+                        continue;
+                    }
+                    std::vector<std::int64_t> arguments;
+                    for (const Operand& operand : instruction.operands) {
+                        arguments.push_back(operand.imm);
+                    }
+                    auto [entry, added] = results.try_emplace({instruction.callee, std::move(arguments)});
+                    if (added) {
+                        entry->second = interpreter.Call(instruction.callee, entry->first.second);
+                    }
+                    if (!entry->second) {
+                        continue;
+                    }
+                    evaluated[block.id][i] = true;
+                    if (instruction.result != NoVReg) {
+                        replacement[instruction.result] = entry->second;
+                    }
+                    if (folded) {
+                        folded->push_back({function.name, instruction.callee, *entry->second});
+                    }
+                    changed = true;
+                }
+            }
+            for (BasicBlock& block : function.blocks) {
+                std::size_t index = 0;
+                std::erase_if(block.instructions, [&](const Instruction&) { return evaluated[block.id][index++]; });
+                for (Instruction& instruction : block.instructions) {
+                    for (Operand& operand : instruction.operands) {
+                        if (operand.isReg() && replacement[operand.reg]) {
+                            operand = Operand::Imm(*replacement[operand.reg]);
+                        }
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+
+    private:
+    Interpreter::Limits limits;
+    std::vector<Folded>* folded;
+};
+
+#endif //CALLEVALUATION_HPP
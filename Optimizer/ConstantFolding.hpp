@@ -0,0 +1,228 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef CONSTANTFOLDING_HPP
+#define CONSTANTFOLDING_HPP
+
+#include <optional>
+#include "../IR/Dominators.hpp"
+#include "../IR/PassManager.hpp"
+
+// Folds arithmetic on constants and propagates constants through locals.
+//
+// A slot that is stored exactly once with a constant holds that constant at
+// every load its store dominates, and any slot holds the constant last stored
+// to it earlier in the same block; such loads become immediates. Registers
+// known to be constant are replaced by immediates in their uses, which may
+// make more arithmetic and more stores constant, so the function is
+// rewritten until nothing changes. Trivial identities (x+0, x*1, x*0, x/1,
+// copies, phis of a single value) are simplified on the way.
+//
+// A division whose divisor becomes zero is left as it is: only a literal
+// zero divisor is an error, which Lowering reports, so whether a program
+// compiles does not depend on what propagation or inlining reveal.
+class ConstantFolding : public Pass {
+    public:
+    [[nodiscard]] std::string_view Name() const override { return "constant-folding"; }
+
+    bool
+    Run(IRModule& module) override {
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            while (RunOnce(function)) {
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    // Result of op on constant operands, with the target's wrapping
+    // semantics, or nothing when op is not foldable.
+    static std::optional<std::int64_t>
+    Evaluate(Opcode op, std::int64_t lhs, std::int64_t rhs = 0) {
+        const auto a = static_cast<std::uint64_t>(lhs);
+        const auto b = static_cast<std::uint64_t>(rhs);
+        switch (op) {
+            case Opcode::Add: return static_cast<std::int64_t>(a + b);
+            case Opcode::Sub: return static_cast<std::int64_t>(a - b);
+            case Opcode::Mul: return static_cast<std::int64_t>(a * b);
+            case Opcode::SDiv:
+                if (rhs == 0) {
+                    return std::nullopt;
+                }
+                if (rhs == -1) {
+                    return static_cast<std::int64_t>(0 - a);
+                }
+                return lhs / rhs;
+            // Shift amounts are taken modulo 64, as AArch64 does.
+            case Opcode::Shl: return static_cast<std::int64_t>(a << (b & 63));
+            case Opcode::AShr: return lhs >> (b & 63);
+            case Opcode::LShr: return static_cast<std::int64_t>(a >> (b & 63));
+            case Opcode::MulHi: return MultiplyHigh(lhs, rhs);
+            case Opcode::Neg: return static_cast<std::int64_t>(0 - a);
+            case Opcode::Copy: return lhs;
+            default: return std::nullopt;
+        }
+    }
+
+    private:
+    // The value a register can be replaced by, if known.
+    std::vector<std::optional<Operand>> replacement;
+
+    Operand
+    Resolve(Operand operand) const {
+        while (operand.isReg() && replacement[operand.reg]) {
+            operand = *replacement[operand.reg];
+        }
+        return operand;
+    }
+
+    // Simplification of an arithmetic instruction whose operands are already
+    // resolved, or nothing if it has to stay.
+    static std::optional<Operand>
+    Simplify(const Instruction& instruction) {
+        const auto& operands = instruction.operands;
+        const auto isImm = [&](std::size_t i, std::int64_t value) {
+            return operands[i].isImm() && operands[i].imm == value;
+        };
+        switch (instruction.op) {
+            case Opcode::Copy:
+                return operands[0];
+            case Opcode::Phi: {
+                // A phi that only ever passes one value on is that value.
+                std::optional<Operand> single;
+                for (const Operand& operand : operands) {
+                    if (operand == Operand::Reg(instruction.result) || operand == single) {
+                        continue;
+                    }
+                    if (single) {
+                        return std::nullopt;
+                    }
+                    single = operand;
+                }
+                return single;
+            }
+            case Opcode::Neg:
+                if (operands[0].isImm()) {
+                    return Operand::Imm(*Evaluate(Opcode::Neg, operands[0].imm));
+                }
+                return std::nullopt;
+            case Opcode::Add:
+            case Opcode::Sub:
+            case Opcode::Mul:
+            case Opcode::SDiv:
+            case Opcode::Shl:
+            case Opcode::AShr:
+            case Opcode::LShr:
+            case Opcode::MulHi:
+                break;
+            default:
+                return std::nullopt;
+        }
+        if (operands[0].isImm() && operands[1].isImm()) {
+            if (const auto value = Evaluate(instruction.op, operands[0].imm, operands[1].imm)) {
+                return Operand::Imm(*value);
+            }
+            return std::nullopt;
+        }
+        switch (instruction.op) {
+            case Opcode::Add:
+                if (isImm(0, 0)) return operands[1];
+                if (isImm(1, 0)) return operands[0];
+                break;
+            case Opcode::Sub:
+                if (isImm(1, 0)) return operands[0];
+                break;
+            case Opcode::Mul:
+                if (isImm(0, 0) || isImm(1, 0)) return Operand::Imm(0);
+                if (isImm(0, 1)) return operands[1];
+                if (isImm(1, 1)) return operands[0];
+                break;
+            case Opcode::SDiv:
+                if (isImm(1, 1)) return operands[0];
+                break;
+            default:
+                break;
+        }
+        return std::nullopt;
+    }
+
+    bool
+    RunOnce(IRFunction& function) {
+        replacement.assign(function.registers.size(), std::nullopt);
+
+        // Constant of each slot stored exactly once with one, and the block
+        // of that store.
+        std::vector<std::uint32_t> stores(function.slots.size(), 0);
+        std::vector<BlockId> storeBlock(function.slots.size(), 0);
+        std::vector<std::optional<std::int64_t>> storedValue(function.slots.size());
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Store) {
+                    stores[instruction.slot]++;
+                    storeBlock[instruction.slot] = block.id;
+                    if (instruction.operands[0].isImm()) {
+                        storedValue[instruction.slot] = instruction.operands[0].imm;
+                    }
+                }
+            }
+        }
+        for (SlotId slot = 0; slot < function.slots.size(); ++slot) {
+            if (stores[slot] != 1) {
+                storedValue[slot] = std::nullopt;
+            }
+        }
+        const DominatorTree dominators(function);
+
+        bool changed = false;
+        std::vector<std::optional<std::int64_t>> blockValue(function.slots.size());
+        for (BasicBlock& block : function.blocks) {
+            std::ranges::fill(blockValue, std::nullopt);
+            std::vector<Instruction> kept;
+            kept.reserve(block.instructions.size());
+            for (Instruction& instruction : block.instructions) {
+                for (Operand& operand : instruction.operands) {
+                    const Operand resolved = Resolve(operand);
+                    changed |= resolved != operand;
+                    operand = resolved;
+                }
+                if (instruction.op == Opcode::Store) {
+                    blockValue[instruction.slot] = instruction.operands[0].isImm()
+                                                       ? std::optional(instruction.operands[0].imm)
+                                                       : std::nullopt;
+                } else if (instruction.op == Opcode::Load) {
+                    const SlotId slot = instruction.slot;
+                    std::optional<std::int64_t> value = blockValue[slot];
+                    if (!value && storedValue[slot] && storeBlock[slot] != block.id && dominators.Dominates(storeBlock[slot], block.id)) {
+                        value = storedValue[slot];
+                    }
+                    if (value) {
+                        replacement[instruction.result] = Operand::Imm(*value);
+                        changed = true;
+                        continue;
+                    }
+                } else if (const auto simplified = Simplify(instruction)) {
+                    replacement[instruction.result] = *simplified;
+                    changed = true;
+                    continue;
+                }
+                kept.push_back(std::move(instruction));
+            }
+            block.instructions = std::move(kept);
+        }
+
+        // Blocks are not visited in dominance order, so a use can come
+        // before the instruction that was replaced.
+        for (BasicBlock& block : function.blocks) {
+            for (Instruction& instruction : block.instructions) {
+                for (Operand& operand : instruction.operands) {
+                    operand = Resolve(operand);
+                }
+            }
+        }
+        return changed;
+    }
+};
+
+#endif //CONSTANTFOLDING_HPP
@@ -0,0 +1,195 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef DEADCODEELIMINATION_HPP
+#define DEADCODEELIMINATION_HPP
+
+#include <algorithm>
+#include "../IR/CallGraph.hpp"
+#include "../IR/Dominators.hpp"
+#include "../IR/Liveness.hpp"
+#include "../IR/PassManager.hpp"
+
+// Removes code whose effect can never be observed:
+//  - blocks that cannot be reached, such as the statements after a return;
+//  - stores to a slot that no later load reads, found with a backward
+//    liveness analysis over slots;
+//  - slots that are no longer read or written, whose frame space is given
+//    back by renumbering the remaining slots;
+//  - instructions whose results are unused. Stores, calls and terminators
+//    are kept, and everything they depend on. Calls stay even when pure,
+//    since a pure function need not terminate;
+//  - functions main no longer calls, once calls were inlined or evaluated.
+//
+// The instructions and stack bytes removed from each function can be
+// collected across several runs of the pass.
+class DeadCodeElimination : public Pass {
+    public:
+    struct Removed {
+        SymbolId function;
+        std::uint32_t instructions = 0;
+        std::uint32_t stackBytes = 0;
+    };
+
+    explicit DeadCodeElimination(std::vector<Removed>* statistics = nullptr) : statistics(statistics) {}
+
+    [[nodiscard]] std::string_view Name() const override { return "dce"; }
+
+    bool
+    Run(IRModule& module) override {
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            std::uint32_t instructions = 0;
+            for (const BasicBlock& block : function.blocks) {
+                instructions += static_cast<std::uint32_t>(block.instructions.size());
+            }
+            const std::uint32_t stackBytes = StackBytes(function);
+
+            RemoveUnreachableBlocks(function);
+            RemoveDeadStores(function);
+            RemoveUnusedSlots(function);
+            RemoveDeadInstructions(function);
+
+            for (const BasicBlock& block : function.blocks) {
+                instructions -= static_cast<std::uint32_t>(block.instructions.size());
+            }
+            const std::uint32_t reclaimed = stackBytes - StackBytes(function);
+            changed |= instructions > 0 || reclaimed > 0;
+            if (statistics) {
+                auto entry = std::ranges::find(*statistics, function.name, &Removed::function);
+                if (entry == statistics->end()) {
+                    entry = statistics->insert(entry, {function.name});
+                }
+                entry->instructions += instructions;
+                entry->stackBytes += reclaimed;
+            }
+        }
+        return RemoveUnreachableFunctions(module) || changed;
+    }
+
+    private:
+    std::vector<Removed>* statistics;
+
+    static std::uint32_t
+    StackBytes(const IRFunction& function) {
+        std::uint32_t bytes = 0;
+        for (const StackSlot& slot : function.slots) {
+            bytes += TypeSize(slot.type);
+        }
+        return bytes;
+    }
+
+    static void
+    RemoveUnreachableBlocks(IRFunction& function) {
+        const DominatorTree dominators(function);
+        std::vector<bool> removed(function.blocks.size(), false);
+        bool any = false;
+        for (const BasicBlock& block : function.blocks) {
+            removed[block.id] = !dominators.isReachable(block.id);
+            any |= removed[block.id];
+        }
+        if (any) {
+            function.RemoveBlocks(removed);
+        }
+    }
+
+    // A store is dead where its slot is not live after it.
+    static void
+    RemoveDeadStores(IRFunction& function) {
+        if (function.slots.empty()) {
+            return;
+        }
+        const SlotLiveness liveness(function);
+        for (BasicBlock& block : function.blocks) {
+            RegisterSet live = liveness.liveOut[block.id];
+            std::vector<bool> dead(block.instructions.size(), false);
+            for (std::size_t i = block.instructions.size(); i-- > 0;) {
+                const Instruction& instruction = block.instructions[i];
+                if (instruction.op == Opcode::Store) {
+                    dead[i] = !live.contains(instruction.slot);
+                    live.erase(instruction.slot);
+                } else if (instruction.op == Opcode::Load) {
+                    live.insert(instruction.slot);
+                }
+            }
+            std::size_t index = 0;
+            std::erase_if(block.instructions, [&](const Instruction&) { return dead[index++]; });
+        }
+    }
+
+    static void
+    RemoveUnusedSlots(IRFunction& function) {
+        std::vector<bool> used(function.slots.size(), false);
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Load || instruction.op == Opcode::Store) {
+                    used[instruction.slot] = true;
+                }
+            }
+        }
+        std::vector<SlotId> renumbered(function.slots.size(), 0);
+        std::vector<StackSlot> kept;
+        for (SlotId slot = 0; slot < function.slots.size(); ++slot) {
+            renumbered[slot] = static_cast<SlotId>(kept.size());
+            if (used[slot]) {
+                kept.push_back(function.slots[slot]);
+            }
+        }
+        if (kept.size() == function.slots.size()) {
+            return;
+        }
+        for (BasicBlock& block : function.blocks) {
+            for (Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Load || instruction.op == Opcode::Store) {
+                    instruction.slot = renumbered[instruction.slot];
+                }
+            }
+        }
+        function.slots = std::move(kept);
+    }
+
+    static bool
+    HasEffect(const Instruction& instruction) {
+        return instruction.op == Opcode::Store || instruction.op == Opcode::Call || instruction.isTerminator();
+    }
+
+    static void
+    RemoveDeadInstructions(IRFunction& function) {
+        std::vector<const Instruction*> definition(function.registers.size(), nullptr);
+        std::vector<bool> live(function.registers.size(), false);
+        std::vector<VReg> work;
+        const auto markOperands = [&](const Instruction& instruction) {
+            for (const Operand& operand : instruction.operands) {
+                if (operand.isReg() && !live[operand.reg]) {
+                    live[operand.reg] = true;
+                    work.push_back(operand.reg);
+                }
+            }
+        };
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                if (instruction.result != NoVReg) {
+                    definition[instruction.result] = &instruction;
+                }
+                if (HasEffect(instruction)) {
+                    markOperands(instruction);
+                }
+            }
+        }
+        while (!work.empty()) {
+            const VReg reg = work.back();
+            work.pop_back();
+            if (definition[reg]) {
+                markOperands(*definition[reg]);
+            }
+        }
+        for (BasicBlock& block : function.blocks) {
+            std::erase_if(block.instructions, [&](const Instruction& instruction) {
+                return !HasEffect(instruction) && !live[instruction.result];
+            });
+        }
+    }
+};
+
+#endif //DEADCODEELIMINATION_HPP
@@ -0,0 +1,170 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef INLINER_HPP
+#define INLINER_HPP
+
+#include "../IR/CallGraph.hpp"
+#include "../IR/PassManager.hpp"
+
+// Replaces calls to small functions of the same unit with a copy of their
+// body. A function's cost is the number of instructions it executes besides
+// its branches and phis; callees costing at most the limit are inlined, and
+// recursive ones never are. Functions are handled bottom-up over the call
+// graph, so a callee has already had its own calls inlined and is costed as
+// it will really be copied.
+//
+// When the unit defines main, functions main no longer reaches are removed.
+// Other units are libraries whose functions may be called from elsewhere.
+class Inliner : public Pass {
+    public:
+    explicit Inliner(std::uint32_t limit) : limit(limit) {}
+
+    [[nodiscard]] std::string_view Name() const override { return "inline"; }
+
+    bool
+    Run(IRModule& module) override {
+        const CallGraph graph(module);
+        std::vector<std::uint32_t> costs(module.functions.size());
+        bool changed = false;
+        for (const auto& component : graph.BottomUp()) {
+            for (const std::size_t function : component) {
+                changed |= InlineCalls(module, graph, costs, function);
+                costs[function] = Cost(module.functions[function]);
+            }
+        }
+        return RemoveUnreachableFunctions(module) || changed;
+    }
+
+    static std::uint32_t
+    Cost(const IRFunction& function) {
+        std::uint32_t cost = 0;
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                cost += instruction.isTerminator() || instruction.op == Opcode::Phi ? 0 : 1;
+            }
+        }
+        return cost;
+    }
+
+    private:
+    std::uint32_t limit;
+
+    // The function to copy in place of call, or nullptr to keep the call.
+    const IRFunction*
+    Inlinable(const IRModule& module, const CallGraph& graph, const std::vector<std::uint32_t>& costs,
+              const Instruction& call) const {
+        if (call.op != Opcode::Call) {
+            return nullptr;
+        }
+        const auto callee = graph.Find(call.callee);
+        if (!callee || graph.IsRecursive(*callee) || costs[*callee] > limit ||
+            module.functions[*callee].parameters.size() != call.operands.size()) {
+            return nullptr;
+        }
+        return &module.functions[*callee];
+    }
+
+    // Each block is split once, however many calls it has: its instructions
+    // are moved out and put back in a single pass, switching to a new block
+    // after every call that is expanded. Copied bodies were scanned as part
+    // of their own function and are not revisited.
+    bool
+    InlineCalls(IRModule& module, const CallGraph& graph, const std::vector<std::uint32_t>& costs, std::size_t caller) {
+        IRFunction& function = module.functions[caller];
+        const auto inlinable = [&](const Instruction& call) { return Inlinable(module, graph, costs, call) != nullptr; };
+        bool changed = false;
+        for (BlockId id = 0, count = static_cast<BlockId>(function.blocks.size()); id < count; ++id) {
+            if (std::ranges::none_of(function.blocks[id].instructions, inlinable)) {
+                continue;
+            }
+            std::vector<Instruction> instructions = std::move(function.blocks[id].instructions);
+            function.blocks[id].instructions.clear();
+            BlockId current = id;
+            for (Instruction& instruction : instructions) {
+                if (const IRFunction* callee = Inlinable(module, graph, costs, instruction)) {
+                    current = InlineCall(function, current, instruction, *callee);
+                } else {
+                    function.blocks[current].instructions.push_back(std::move(instruction));
+                }
+            }
+            // Phis after the block now see the last piece of it.
+            for (const BlockId successor : function.blocks[current].Successors()) {
+                for (Instruction& phi : function.blocks[successor].instructions) {
+                    if (phi.op != Opcode::Phi) {
+                        break;
+                    }
+                    std::ranges::replace(phi.blocks, id, current);
+                }
+            }
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Ends block id with a branch into a copy of callee in place of call,
+    // and returns the new, empty block the copy returns to.
+    static BlockId
+    InlineCall(IRFunction& function, BlockId id, const Instruction& call, const IRFunction& callee) {
+        const BlockId continuation = function.NewBlock();
+
+        // Copy the callee with its registers, slots and blocks renumbered
+        // past the caller's. Its entry block has no predecessors, so the
+        // branch into it needs no phi operands; the parameters are copied
+        // from the arguments just before it.
+        const auto registerBase = static_cast<VReg>(function.registers.size());
+        const auto slotBase = static_cast<SlotId>(function.slots.size());
+        const auto blockBase = static_cast<BlockId>(function.blocks.size());
+        function.registers.insert(function.registers.end(), callee.registers.begin(), callee.registers.end());
+        function.slots.insert(function.slots.end(), callee.slots.begin(), callee.slots.end());
+        std::vector<Operand> returned;
+        std::vector<BlockId> returning;
+        for (const BasicBlock& block : callee.blocks) {
+            const BlockId copy = function.NewBlock();
+            function.blocks[copy].instructions.reserve(block.instructions.size());
+            for (Instruction instruction : block.instructions) {
+                if (instruction.result != NoVReg) {
+                    instruction.result += registerBase;
+                }
+                for (Operand& operand : instruction.operands) {
+                    if (operand.isReg()) {
+                        operand.reg += registerBase;
+                    }
+                }
+                for (BlockId& target : instruction.blocks) {
+                    target += blockBase;
+                }
+                if (instruction.op == Opcode::Load || instruction.op == Opcode::Store) {
+                    instruction.slot += slotBase;
+                }
+                if (instruction.op == Opcode::Ret) {
+                    returned.push_back(instruction.operands.empty() ? Operand::Imm(0) : instruction.operands[0]);
+                    returning.push_back(copy);
+                    instruction = {.op = Opcode::Br, .blocks = {continuation}};
+                }
+                function.blocks[copy].instructions.push_back(std::move(instruction));
+            }
+        }
+        for (std::size_t i = 0; i < callee.parameters.size(); ++i) {
+            function.blocks[id].instructions.push_back(
+                {.op = Opcode::Copy, .result = callee.parameters[i] + registerBase, .operands = {call.operands[i]}});
+        }
+        function.blocks[id].instructions.push_back({.op = Opcode::Br, .blocks = {blockBase}});
+
+        // The call's result becomes the value returned, merged with a phi
+        // when the callee returns from several places.
+        if (call.result != NoVReg) {
+            Instruction result = {.op = Opcode::Copy, .result = call.result, .operands = {Operand::Imm(0)}};
+            if (returned.size() == 1) {
+                result.operands = returned;
+            } else if (returned.size() > 1) {
+                result = {.op = Opcode::Phi, .result = call.result, .operands = returned, .blocks = returning};
+            }
+            function.blocks[continuation].instructions.push_back(std::move(result));
+        }
+        return continuation;
+    }
+};
+
+#endif //INLINER_HPP
@@ -0,0 +1,101 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Generator/CompilerOptions.hpp"
+
+// The passes each optimization level runs, in order:
+//
+//   -O0  nothing; every local stays in memory, for the fastest builds.
+//   -O1  cheap passes that work within a function: locals to registers,
+//        folding, redundancy and dead code removal, peephole.
+//   -O2  everything, interprocedural passes included.
+//   -Os  -O2 without rewrites that grow the code: only callees no bigger
+//        than a call are inlined, and divisions stay sdiv.
+//
+// -f<pass> and -fno-<pass> add or remove every step of a pass after the
+// level has chosen; an added pass runs where it would at the levels that
+// have it. The last two steps belong to the code generators: "tail-calls"
+// lets a call whose result is returned reuse the caller's frame, and
+// "peephole" runs on the AArch64 assembly, after all the others.
+class Pipeline {
+    public:
+    static constexpr std::uint32_t DefaultInlineLimit = 20;
+    // Inlining a callee this small replaces the call sequence with no more
+    // code than it had.
+    static constexpr std::uint32_t SizeInlineLimit = 3;
+
+    // Names of the passes options selects, in the order they run.
+    static std::vector<std::string_view>
+    Passes(const CompilerOptions& options) {
+        for (const auto& [pass, enabled] : options.passToggles) {
+            if (std::ranges::none_of(Steps, [&](const Step& step) { return step.pass == pass; })) {
+                throw std::runtime_error("Unknown pass '" + pass + "' in -f" + (enabled ? "" : "no-") + pass);
+            }
+        }
+        std::vector<std::string_view> passes;
+        for (const Step& step : Steps) {
+            bool enabled = (step.levels >> static_cast<unsigned>(options.optimization) & 1) != 0;
+            for (const auto& [pass, toggle] : options.passToggles) {
+                enabled = pass == step.pass ? toggle : enabled;
+            }
+            if (enabled) {
+                passes.push_back(step.pass);
+            }
+        }
+        return passes;
+    }
+
+    static bool
+    Runs(const CompilerOptions& options, std::string_view pass) {
+        const std::vector<std::string_view> passes = Passes(options);
+        return std::ranges::find(passes, pass) != passes.end();
+    }
+
+    static std::uint32_t
+    InlineLimit(const CompilerOptions& options) {
+        if (options.inlineLimit) {
+            return *options.inlineLimit;
+        }
+        return options.optimization == OptimizationLevel::Os ? SizeInlineLimit : DefaultInlineLimit;
+    }
+
+    private:
+    struct Step {
+        std::string_view pass;
+        std::uint8_t levels;
+    };
+
+    // Levels a step runs at, one bit per OptimizationLevel.
+    static constexpr std::uint8_t O1 = 1 << static_cast<int>(OptimizationLevel::O1);
+    static constexpr std::uint8_t O2 = 1 << static_cast<int>(OptimizationLevel::O2);
+    static constexpr std::uint8_t Os = 1 << static_cast<int>(OptimizationLevel::Os);
+
+    static constexpr Step Steps[] = {
+        {"dce", O1 | O2 | Os},
+        {"mem2reg", O1 | O2 | Os},
+        {"tail-recursion", O2 | Os},
+        // Merging repeated calls first means each is inlined only once.
+        {"value-numbering", O2 | Os},
+        {"inline", O2 | Os},
+        {"simplify-cfg", O2 | Os},
+        {"constant-folding", O1 | O2 | Os},
+        {"evaluate-calls", O2 | Os},
+        {"constant-folding", O2 | Os},
+        {"value-numbering", O1 | O2 | Os},
+        {"strength-reduction", O1 | O2},
+        {"dce", O1 | O2 | Os},
+        {"tail-calls", O2 | Os},
+        {"peephole", O1 | O2 | Os},
+    };
+};
+
+#endif //PIPELINE_HPP
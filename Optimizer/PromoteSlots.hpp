@@ -0,0 +1,234 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef PROMOTESLOTS_HPP
+#define PROMOTESLOTS_HPP
+
+#include <optional>
+#include "../IR/Dominators.hpp"
+#include "../IR/PassManager.hpp"
+
+// Promotes locals from stack slots to SSA registers (mem2reg). Phis are
+// placed on the iterated dominance frontier of each slot's stores, then loads
+// and stores are replaced by walking the dominator tree with the current
+// value of every slot (Cytron et al.). Phis nothing ends up using are
+// removed again. Locals never have their address taken, so every slot is
+// promoted and the function is left without any.
+class PromoteSlots : public Pass {
+    public:
+    [[nodiscard]] std::string_view Name() const override { return "mem2reg"; }
+
+    bool
+    Run(IRModule& module) override {
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            if (!function.slots.empty()) {
+                Promote(function);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    private:
+    static void
+    Promote(IRFunction& function) {
+        const DominatorTree dominators(function);
+        const auto predecessors = function.Predecessors();
+        const auto frontiers = dominators.Frontiers(function);
+        const std::size_t slotCount = function.slots.size();
+
+        // Phi placement. phiSlot maps each new phi register to its slot.
+        std::vector<SlotId> phiSlot(function.registers.size(), NoSlot);
+        std::vector<std::vector<bool>> hasPhi(slotCount, std::vector<bool>(function.blocks.size(), false));
+        for (SlotId slot = 0; slot < slotCount; ++slot) {
+            std::vector<BlockId> work;
+            for (const BasicBlock& block : function.blocks) {
+                if (dominators.isReachable(block.id) && std::ranges::any_of(block.instructions, [&](const Instruction& instruction) {
+                        return instruction.op == Opcode::Store && instruction.slot == slot;
+                    })) {
+                    work.push_back(block.id);
+                }
+            }
+            while (!work.empty()) {
+                const BlockId block = work.back();
+                work.pop_back();
+                for (const BlockId join : frontiers[block]) {
+                    if (hasPhi[slot][join]) {
+                        continue;
+                    }
+                    hasPhi[slot][join] = true;
+                    const VReg result = function.NewRegister(function.slots[slot].type);
+                    phiSlot.resize(function.registers.size(), NoSlot);
+                    phiSlot[result] = slot;
+                    auto& instructions = function.blocks[join].instructions;
+                    instructions.insert(instructions.begin(), {
+                        .op = Opcode::Phi,
+                        .result = result,
+                        .operands = std::vector<Operand>(predecessors[join].size(), Operand::Imm(0)),
+                        .blocks = predecessors[join],
+                    });
+                    work.push_back(join);
+                }
+            }
+        }
+
+        // Renaming, over the dominator tree in preorder with an explicit
+        // stack. A slot read before any store holds 0, as the frame would.
+        std::vector<std::optional<Operand>> replacement(function.registers.size());
+        const auto resolve = [&](Operand operand) {
+            while (operand.isReg() && replacement[operand.reg]) {
+                operand = *replacement[operand.reg];
+            }
+            return operand;
+        };
+        std::vector<std::vector<Operand>> current(slotCount);
+        const auto top = [&](SlotId slot) {
+            return current[slot].empty() ? Operand::Imm(0) : current[slot].back();
+        };
+        struct Frame {
+            BlockId block;
+            std::size_t child;
+            std::vector<SlotId> pushed;
+        };
+        std::vector<Frame> stack = {{0, 0, {}}};
+        bool entering = true;
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (entering) {
+                RenameBlock(function, frame.block, phiSlot, replacement, resolve, current, frame.pushed);
+                for (const BlockId successor : function.blocks[frame.block].Successors()) {
+                    for (Instruction& phi : function.blocks[successor].instructions) {
+                        if (phi.op != Opcode::Phi) {
+                            break;
+                        }
+                        for (std::size_t i = 0; i < phi.blocks.size(); ++i) {
+                            if (phi.blocks[i] == frame.block && IsPromotedPhi(phi, phiSlot)) {
+                                phi.operands[i] = top(phiSlot[phi.result]);
+                            }
+                        }
+                    }
+                }
+            }
+            const auto& children = dominators.Children(frame.block);
+            if (frame.child < children.size()) {
+                const BlockId child = children[frame.child++];
+                stack.push_back({child, 0, {}});
+                entering = true;
+                continue;
+            }
+            for (const SlotId slot : frame.pushed) {
+                current[slot].pop_back();
+            }
+            stack.pop_back();
+            entering = false;
+        }
+
+        // Unreachable blocks never run; their loads read 0.
+        for (BasicBlock& block : function.blocks) {
+            if (dominators.isReachable(block.id)) {
+                continue;
+            }
+            std::erase_if(block.instructions, [&](const Instruction& instruction) {
+                if (instruction.op == Opcode::Load) {
+                    replacement[instruction.result] = Operand::Imm(0);
+                }
+                return instruction.op == Opcode::Load || instruction.op == Opcode::Store;
+            });
+        }
+        for (BasicBlock& block : function.blocks) {
+            for (Instruction& instruction : block.instructions) {
+                for (Operand& operand : instruction.operands) {
+                    operand = resolve(operand);
+                }
+            }
+        }
+        RemoveDeadPhis(function);
+        function.slots.clear();
+    }
+
+    static constexpr SlotId NoSlot = std::numeric_limits<SlotId>::max();
+
+    static bool
+    IsPromotedPhi(const Instruction& phi, const std::vector<SlotId>& phiSlot) {
+        return phi.result < phiSlot.size() && phiSlot[phi.result] != NoSlot;
+    }
+
+    template <typename Resolve>
+    static void
+    RenameBlock(IRFunction& function, BlockId id, const std::vector<SlotId>& phiSlot,
+                std::vector<std::optional<Operand>>& replacement, const Resolve& resolve,
+                std::vector<std::vector<Operand>>& current, std::vector<SlotId>& pushed) {
+        std::vector<Instruction> kept;
+        auto& instructions = function.blocks[id].instructions;
+        kept.reserve(instructions.size());
+        for (Instruction& instruction : instructions) {
+            for (Operand& operand : instruction.operands) {
+                operand = resolve(operand);
+            }
+            switch (instruction.op) {
+                case Opcode::Phi:
+                    if (IsPromotedPhi(instruction, phiSlot)) {
+                        current[phiSlot[instruction.result]].push_back(Operand::Reg(instruction.result));
+                        pushed.push_back(phiSlot[instruction.result]);
+                    }
+                    break;
+                case Opcode::Load:
+                    replacement[instruction.result] = current[instruction.slot].empty() ? Operand::Imm(0) : current[instruction.slot].back();
+                    continue;
+                case Opcode::Store:
+                    current[instruction.slot].push_back(instruction.operands[0]);
+                    pushed.push_back(instruction.slot);
+                    continue;
+                default:
+                    break;
+            }
+            kept.push_back(std::move(instruction));
+        }
+        instructions = std::move(kept);
+    }
+
+    // Keeps the phis that a non-phi instruction depends on, directly or
+    // through other phis.
+    static void
+    RemoveDeadPhis(IRFunction& function) {
+        std::vector<const Instruction*> definition(function.registers.size(), nullptr);
+        std::vector<bool> live(function.registers.size(), false);
+        std::vector<VReg> work;
+        for (const BasicBlock& block : function.blocks) {
+            for (const Instruction& instruction : block.instructions) {
+                if (instruction.op == Opcode::Phi) {
+                    definition[instruction.result] = &instruction;
+                    continue;
+                }
+                for (const Operand& operand : instruction.operands) {
+                    if (operand.isReg() && !live[operand.reg]) {
+                        live[operand.reg] = true;
+                        work.push_back(operand.reg);
+                    }
+                }
+            }
+        }
+        while (!work.empty()) {
+            const VReg reg = work.back();
+            work.pop_back();
+            if (!definition[reg]) {
+                continue;
+            }
+            for (const Operand& operand : definition[reg]->operands) {
+                if (operand.isReg() && !live[operand.reg]) {
+                    live[operand.reg] = true;
+                    work.push_back(operand.reg);
+                }
+            }
+        }
+        for (BasicBlock& block : function.blocks) {
+            std::erase_if(block.instructions, [&](const Instruction& instruction) {
+                return instruction.op == Opcode::Phi && !live[instruction.result];
+            });
+        }
+    }
+};
+
+#endif //PROMOTESLOTS_HPP
@@ -0,0 +1,102 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef SIMPLIFYCFG_HPP
+#define SIMPLIFYCFG_HPP
+
+#include <algorithm>
+#include <optional>
+#include "../IR/PassManager.hpp"
+
+// Merges a block into its predecessor when the predecessor branches nowhere
+// else and the block has no other way in. Inlining leaves such chains at
+// every call site it expands; merging them saves the branches and gives the
+// register allocator and later passes longer straight-line code.
+class SimplifyCFG : public Pass {
+    public:
+    [[nodiscard]] std::string_view Name() const override { return "simplify-cfg"; }
+
+    bool
+    Run(IRModule& module) override {
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            changed |= MergeBlocks(function);
+        }
+        return changed;
+    }
+
+    private:
+    static bool
+    MergeBlocks(IRFunction& function) {
+        auto predecessors = function.Predecessors();
+        std::vector<bool> removed(function.blocks.size(), false);
+        // Phis with a single predecessor are copies of their operand. Their
+        // uses are rewritten once, after every merge.
+        std::vector<std::optional<Operand>> replacement(function.registers.size());
+        bool replaced = false;
+        bool changed = false;
+        for (BasicBlock& block : function.blocks) {
+            if (removed[block.id]) {
+                continue;
+            }
+            // Absorb successors for as long as the chain goes on.
+            while (true) {
+                const Instruction& terminator = block.terminator();
+                if (terminator.op != Opcode::Br) {
+                    break;
+                }
+                const BlockId next = terminator.blocks[0];
+                if (next == 0 || next == block.id || predecessors[next].size() != 1) {
+                    break;
+                }
+                BasicBlock& successor = function.blocks[next];
+                std::size_t first = 0;
+                while (first < successor.instructions.size() && successor.instructions[first].op == Opcode::Phi) {
+                    replacement[successor.instructions[first].result] = successor.instructions[first].operands[0];
+                    replaced = true;
+                    ++first;
+                }
+                block.instructions.pop_back();
+                block.instructions.insert(block.instructions.end(),
+                                          std::make_move_iterator(successor.instructions.begin() + static_cast<std::ptrdiff_t>(first)),
+                                          std::make_move_iterator(successor.instructions.end()));
+                successor.instructions.clear();
+                // Phis further on now see this block where they saw the successor.
+                for (const BlockId after : block.Successors()) {
+                    for (Instruction& phi : function.blocks[after].instructions) {
+                        if (phi.op != Opcode::Phi) {
+                            break;
+                        }
+                        std::ranges::replace(phi.blocks, next, block.id);
+                    }
+                    std::ranges::replace(predecessors[after], next, block.id);
+                }
+                removed[next] = true;
+                changed = true;
+            }
+        }
+        if (replaced) {
+            Replace(function, replacement);
+        }
+        if (changed) {
+            function.RemoveBlocks(removed);
+        }
+        return changed;
+    }
+
+    static void
+    Replace(IRFunction& function, const std::vector<std::optional<Operand>>& replacement) {
+        for (BasicBlock& block : function.blocks) {
+            for (Instruction& instruction : block.instructions) {
+                for (Operand& operand : instruction.operands) {
+                    while (operand.isReg() && replacement[operand.reg]) {
+                        operand = *replacement[operand.reg];
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif //SIMPLIFYCFG_HPP
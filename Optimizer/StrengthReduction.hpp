@@ -0,0 +1,183 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef STRENGTHREDUCTION_HPP
+#define STRENGTHREDUCTION_HPP
+
+#include <bit>
+#include "../IR/PassManager.hpp"
+
+// Replaces multiplication and signed division by a constant with cheaper
+// sequences.
+//
+// x * c becomes a shift when c is a power of two, and a shift and an add or
+// subtract when c is one more or one less than a power of two; anything
+// else needs its constant in a register and stays a mul.
+//
+// x / d rounds toward zero. For d = ±2^k, a negative x is first biased by
+// 2^k - 1 (its sign bits shifted down), then shifted right arithmetically.
+// For other d the quotient is the high half of x times a magic number,
+// corrected by x when the magic number's sign is wrong for d, shifted, and
+// incremented when negative (Hacker's Delight, 10-1). sdiv takes tens of
+// cycles; these take a few.
+class StrengthReduction : public Pass {
+    public:
+    [[nodiscard]] std::string_view Name() const override { return "strength-reduction"; }
+
+    bool
+    Run(IRModule& module) override {
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            for (BasicBlock& block : function.blocks) {
+                std::vector<Instruction> rewritten;
+                rewritten.reserve(block.instructions.size());
+                for (Instruction& instruction : block.instructions) {
+                    Emitter emit{function, rewritten};
+                    if (Reduce(instruction, emit)) {
+                        changed = true;
+                    } else {
+                        rewritten.push_back(std::move(instruction));
+                    }
+                }
+                block.instructions = std::move(rewritten);
+            }
+        }
+        return changed;
+    }
+
+    // Magic multiplier and shift for signed division by d, |d| >= 2.
+    struct Magic {
+        std::int64_t multiplier;
+        int shift;
+    };
+
+    static Magic
+    MagicFor(std::int64_t d) {
+        constexpr std::uint64_t two63 = std::uint64_t{1} << 63;
+        const std::uint64_t ad = d < 0 ? 0 - static_cast<std::uint64_t>(d) : static_cast<std::uint64_t>(d);
+        const std::uint64_t t = two63 + (static_cast<std::uint64_t>(d) >> 63);
+        const std::uint64_t anc = t - 1 - t % ad; // |nc|
+        int p = 63;
+        std::uint64_t q1 = two63 / anc, r1 = two63 - q1 * anc; // 2^p / |nc|
+        std::uint64_t q2 = two63 / ad, r2 = two63 - q2 * ad;   // 2^p / |d|
+        std::uint64_t delta;
+        do {
+            ++p;
+            q1 *= 2;
+            r1 *= 2;
+            if (r1 >= anc) {
+                ++q1;
+                r1 -= anc;
+            }
+            q2 *= 2;
+            r2 *= 2;
+            if (r2 >= ad) {
+                ++q2;
+                r2 -= ad;
+            }
+            delta = ad - r2;
+        } while (q1 < delta || (q1 == delta && r1 == 0));
+        const std::uint64_t magic = q2 + 1;
+        return {static_cast<std::int64_t>(d < 0 ? 0 - magic : magic), p - 64};
+    }
+
+    private:
+    // Appends instructions in place of the one being reduced; the last one
+    // takes over its result register.
+    struct Emitter {
+        IRFunction& function;
+        std::vector<Instruction>& out;
+
+        Operand
+        operator()(Opcode op, Operand lhs, Operand rhs, VReg result = NoVReg) {
+            if (result == NoVReg) {
+                result = function.NewRegister(IRType::I64);
+            }
+            out.push_back({.op = op, .result = result, .operands = {lhs, rhs}});
+            return Operand::Reg(result);
+        }
+
+        void
+        Negate(Operand value, VReg result) {
+            out.push_back({.op = Opcode::Neg, .result = result, .operands = {value}});
+        }
+    };
+
+    static bool
+    Reduce(const Instruction& instruction, Emitter& emit) {
+        if (instruction.op == Opcode::Mul) {
+            Operand x = instruction.operands[0];
+            Operand c = instruction.operands[1];
+            if (x.isImm()) {
+                std::swap(x, c);
+            }
+            return x.isReg() && c.isImm() && ReduceMultiply(x, c.imm, instruction.result, emit);
+        }
+        if (instruction.op == Opcode::SDiv) {
+            const Operand x = instruction.operands[0];
+            const Operand d = instruction.operands[1];
+            return x.isReg() && d.isImm() && ReduceDivide(x, d.imm, instruction.result, emit);
+        }
+        return false;
+    }
+
+    static bool
+    ReduceMultiply(Operand x, std::int64_t c, VReg result, Emitter& emit) {
+        if (c <= 1) {
+            return false;
+        }
+        const auto value = static_cast<std::uint64_t>(c);
+        if (std::has_single_bit(value)) {
+            emit(Opcode::Shl, x, Operand::Imm(std::countr_zero(value)), result);
+        } else if (std::has_single_bit(value - 1)) {
+            const Operand shifted = emit(Opcode::Shl, x, Operand::Imm(std::countr_zero(value - 1)));
+            emit(Opcode::Add, shifted, x, result);
+        } else if (std::has_single_bit(value + 1)) {
+            const Operand shifted = emit(Opcode::Shl, x, Operand::Imm(std::countr_zero(value + 1)));
+            emit(Opcode::Sub, shifted, x, result);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    static bool
+    ReduceDivide(Operand x, std::int64_t d, VReg result, Emitter& emit) {
+        if (d == 0 || d == 1) {
+            return false;
+        }
+        if (d == -1) {
+            emit.Negate(x, result);
+            return true;
+        }
+        const std::uint64_t magnitude = d < 0 ? 0 - static_cast<std::uint64_t>(d) : static_cast<std::uint64_t>(d);
+        if (std::has_single_bit(magnitude)) {
+            const int k = std::countr_zero(magnitude);
+            const Operand sign = k == 1 ? x : emit(Opcode::AShr, x, Operand::Imm(63));
+            const Operand bias = emit(Opcode::LShr, sign, Operand::Imm(64 - k));
+            const Operand biased = emit(Opcode::Add, x, bias);
+            if (d > 0) {
+                emit(Opcode::AShr, biased, Operand::Imm(k), result);
+            } else {
+                emit.Negate(emit(Opcode::AShr, biased, Operand::Imm(k)), result);
+            }
+            return true;
+        }
+        const auto [multiplier, shift] = MagicFor(d);
+        Operand quotient = emit(Opcode::MulHi, x, Operand::Imm(multiplier));
+        if (d > 0 && multiplier < 0) {
+            quotient = emit(Opcode::Add, quotient, x);
+        } else if (d < 0 && multiplier > 0) {
+            quotient = emit(Opcode::Sub, quotient, x);
+        }
+        if (shift > 0) {
+            quotient = emit(Opcode::AShr, quotient, Operand::Imm(shift));
+        }
+        const Operand negative = emit(Opcode::LShr, quotient, Operand::Imm(63));
+        emit(Opcode::Add, quotient, negative, result);
+        return true;
+    }
+};
+
+#endif //STRENGTHREDUCTION_HPP
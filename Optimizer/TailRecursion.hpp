@@ -0,0 +1,120 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef TAILRECURSION_HPP
+#define TAILRECURSION_HPP
+
+#include <algorithm>
+#include "../IR/PassManager.hpp"
+
+// Turns self-recursive calls in tail position, a call whose result is
+// returned right away, into a branch back to the start of the function, so
+// the recursion runs in a loop in a single frame.
+//
+// The body of the entry block moves to a new header block that the entry
+// branches to and the tail calls branch back to; the entry block keeps no
+// predecessors, which everything else relies on. Each parameter is replaced
+// in the body by a phi in the header, taking the argument passed on entry or
+// by each tail call. Functions that still have stack slots are left alone,
+// since a new call would start from fresh slots.
+class TailRecursion : public Pass {
+    public:
+    [[nodiscard]] std::string_view Name() const override { return "tail-recursion"; }
+
+    bool
+    Run(IRModule& module) override {
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            if (function.slots.empty()) {
+                changed |= EliminateTailCalls(function);
+            }
+        }
+        return changed;
+    }
+
+    // Whether instructions[index] is a call whose result is returned by the
+    // instruction after it.
+    static bool
+    IsTailCall(const BasicBlock& block, std::size_t index) {
+        const auto& instructions = block.instructions;
+        if (instructions[index].op != Opcode::Call || index + 1 >= instructions.size()) {
+            return false;
+        }
+        const Instruction& next = instructions[index + 1];
+        return next.op == Opcode::Ret &&
+               (next.operands.empty() || next.operands[0] == Operand::Reg(instructions[index].result));
+    }
+
+    private:
+    static bool
+    EliminateTailCalls(IRFunction& function) {
+        std::vector<BlockId> tails;
+        for (const BasicBlock& block : function.blocks) {
+            const std::size_t size = block.instructions.size();
+            if (size < 2 || !IsTailCall(block, size - 2)) {
+                continue;
+            }
+            const Instruction& call = block.instructions[size - 2];
+            if (call.callee == function.name && call.operands.size() == function.parameters.size()) {
+                tails.push_back(block.id);
+            }
+        }
+        if (tails.empty()) {
+            return false;
+        }
+
+        // Uses of the parameters, the tail calls' arguments among them, now
+        // read the header's phis.
+        std::vector<Operand> renamed(function.registers.size());
+        for (const VReg parameter : function.parameters) {
+            renamed[parameter] = Operand::Reg(function.NewRegister(IRType::I64));
+        }
+        for (BasicBlock& block : function.blocks) {
+            for (Instruction& instruction : block.instructions) {
+                for (Operand& operand : instruction.operands) {
+                    if (operand.isReg() && operand.reg < renamed.size() && renamed[operand.reg].isReg()) {
+                        operand = renamed[operand.reg];
+                    }
+                }
+            }
+        }
+
+        const BlockId header = function.NewBlock();
+        std::vector<Instruction> phis;
+        for (const VReg parameter : function.parameters) {
+            phis.push_back({.op = Opcode::Phi, .result = renamed[parameter].reg, .operands = {Operand::Reg(parameter)}, .blocks = {0}});
+        }
+        for (const BlockId tail : tails) {
+            const auto& instructions = function.blocks[tail].instructions;
+            const Instruction& call = instructions[instructions.size() - 2];
+            for (std::size_t i = 0; i < phis.size(); ++i) {
+                phis[i].operands.push_back(call.operands[i]);
+                phis[i].blocks.push_back(tail == 0 ? header : tail);
+            }
+        }
+        function.blocks[header].instructions = std::move(phis);
+        function.blocks[header].instructions.insert(function.blocks[header].instructions.end(),
+                                                    std::make_move_iterator(function.blocks[0].instructions.begin()),
+                                                    std::make_move_iterator(function.blocks[0].instructions.end()));
+        function.blocks[0].instructions = {{.op = Opcode::Br, .blocks = {header}}};
+        for (const BlockId successor : function.blocks[header].Successors()) {
+            for (Instruction& phi : function.blocks[successor].instructions) {
+                if (phi.op != Opcode::Phi) {
+                    break;
+                }
+                std::ranges::replace(phi.blocks, BlockId{0}, header);
+            }
+        }
+        for (BlockId tail : tails) {
+            // The entry's own tail call now sits in the header.
+            tail = tail == 0 ? header : tail;
+            auto& instructions = function.blocks[tail].instructions;
+            instructions.resize(instructions.size() - 2);
+            instructions.push_back({.op = Opcode::Br, .blocks = {header}});
+        }
+        return true;
+    }
+};
+
+#endif //TAILRECURSION_HPP
@@ -0,0 +1,176 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef VALUENUMBERING_HPP
+#define VALUENUMBERING_HPP
+
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include "../IR/Dominators.hpp"
+#include "../IR/Effects.hpp"
+#include "../IR/PassManager.hpp"
+
+// Removes recomputations of values that are already available (dominator
+// based value numbering). Every pure instruction is hash-consed on its
+// opcode, callee and operands, with the operands of commutative ones in a
+// fixed order, in a table scoped to the dominator tree; an instruction
+// found in the table is replaced by the earlier result. Arithmetic and
+// calls to pure functions are numbered this way. Calls to read-only
+// functions are only merged within a block, up to the next call that may
+// write memory.
+class ValueNumbering : public Pass {
+    public:
+    [[nodiscard]] std::string_view Name() const override { return "value-numbering"; }
+
+    bool
+    Run(IRModule& module) override {
+        const CallGraph graph(module);
+        const EffectAnalysis effects(module, graph);
+        bool changed = false;
+        for (IRFunction& function : module.functions) {
+            changed |= NumberValues(function, effects);
+        }
+        return changed;
+    }
+
+    private:
+    struct Expression {
+        Opcode op;
+        SymbolId callee;
+        std::vector<Operand> operands;
+
+        bool operator==(const Expression&) const = default;
+    };
+
+    struct ExpressionHash {
+        std::size_t
+        operator()(const Expression& expression) const {
+            std::size_t hash = static_cast<std::size_t>(expression.op) * 31 + expression.callee;
+            for (const Operand& operand : expression.operands) {
+                const auto bits = operand.isReg() ? operand.reg : static_cast<std::uint64_t>(operand.imm);
+                hash = (hash ^ (bits + static_cast<std::size_t>(operand.kind))) * 0x9E3779B97F4A7C15ull;
+            }
+            return hash;
+        }
+    };
+
+    using Table = std::unordered_map<Expression, VReg, ExpressionHash>;
+
+    static bool
+    IsNumbered(const Instruction& instruction, const EffectAnalysis& effects) {
+        switch (instruction.op) {
+            case Opcode::Add:
+            case Opcode::Sub:
+            case Opcode::Mul:
+            case Opcode::SDiv:
+            case Opcode::Shl:
+            case Opcode::AShr:
+            case Opcode::LShr:
+            case Opcode::MulHi:
+            case Opcode::Neg:
+            case Opcode::Copy:
+                return true;
+            case Opcode::Call:
+                return effects.Of(instruction.callee) != Effect::Unknown;
+            default:
+                return false;
+        }
+    }
+
+    static Expression
+    Key(const Instruction& instruction) {
+        Expression expression = {instruction.op, instruction.callee, instruction.operands};
+        if (instruction.op == Opcode::Add || instruction.op == Opcode::Mul || instruction.op == Opcode::MulHi) {
+            auto& operands = expression.operands;
+            const auto order = [](const Operand& operand) {
+                return std::pair(operand.isReg() ? 0 : 1, operand.isReg() ? operand.reg : static_cast<std::uint64_t>(operand.imm));
+            };
+            if (order(operands[1]) < order(operands[0])) {
+                std::swap(operands[0], operands[1]);
+            }
+        }
+        return expression;
+    }
+
+    static bool
+    NumberValues(IRFunction& function, const EffectAnalysis& effects) {
+        const DominatorTree dominators(function);
+        std::vector<std::optional<VReg>> replacement(function.registers.size());
+        const auto resolve = [&](Operand& operand) {
+            while (operand.isReg() && replacement[operand.reg]) {
+                operand.reg = *replacement[operand.reg];
+            }
+        };
+        Table available;
+        struct Frame {
+            BlockId block;
+            std::size_t child;
+            std::vector<Expression> added;
+        };
+        std::vector<Frame> stack = {{0, 0, {}}};
+        bool entering = true;
+        bool changed = false;
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            if (entering) {
+                Table readOnly;
+                std::vector<Instruction> kept;
+                auto& instructions = function.blocks[frame.block].instructions;
+                kept.reserve(instructions.size());
+                for (Instruction& instruction : instructions) {
+                    for (Operand& operand : instruction.operands) {
+                        resolve(operand);
+                    }
+                    if (instruction.op == Opcode::Call && effects.Of(instruction.callee) == Effect::Unknown) {
+                        readOnly.clear();
+                    }
+                    if (IsNumbered(instruction, effects)) {
+                        Expression key = Key(instruction);
+                        const bool scoped = instruction.op != Opcode::Call || effects.Of(instruction.callee) == Effect::Pure;
+                        Table& table = scoped ? available : readOnly;
+                        if (const auto found = table.find(key); found != table.end()) {
+                            replacement[instruction.result] = found->second;
+                            changed = true;
+                            continue;
+                        }
+                        table.emplace(key, instruction.result);
+                        if (scoped) {
+                            frame.added.push_back(std::move(key));
+                        }
+                    }
+                    kept.push_back(std::move(instruction));
+                }
+                instructions = std::move(kept);
+            }
+            const auto& children = dominators.Children(frame.block);
+            if (frame.child < children.size()) {
+                const BlockId child = children[frame.child++];
+                stack.push_back({child, 0, {}});
+                entering = true;
+                continue;
+            }
+            for (const Expression& key : frame.added) {
+                available.erase(key);
+            }
+            stack.pop_back();
+            entering = false;
+        }
+
+        // Phi operands arrive from predecessors that may come later in the
+        // walk than the phi itself.
+        if (changed) {
+            for (BasicBlock& block : function.blocks) {
+                for (Instruction& instruction : block.instructions) {
+                    for (Operand& operand : instruction.operands) {
+                        resolve(operand);
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+};
+
+#endif //VALUENUMBERING_HPP
@@ -0,0 +1,62 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef ASTVISITOR_HPP
+#define ASTVISITOR_HPP
+
+#include "ParserTypes.hpp"
+
+// Dispatches on ASTNode::kind with a single switch instead of RTTI. Derived
+// passes override the Visit* methods they care about (CRTP, no virtual
+// calls); anything not overridden goes to VisitNode. All visits are const,
+// so any number of passes can walk the same tree.
+template <typename Derived, typename Result = void>
+class ASTVisitor {
+public:
+    Result Visit(const ASTNode* node) {
+        switch (node->kind) {
+            case NodeKind::CompilationUnit: return Self().VisitCompilationUnit(static_cast<const CompilationUnit*>(node));
+            case NodeKind::FunctionDef: return Self().VisitFunctionDef(static_cast<const FunctionDef*>(node));
+            case NodeKind::Return: return Self().VisitReturn(static_cast<const Return*>(node));
+            case NodeKind::Declare: return Self().VisitDeclare(static_cast<const Declare*>(node));
+            case NodeKind::ExpStatement: return Self().VisitExpStatement(static_cast<const ExpStatement*>(node));
+            case NodeKind::ClassDef: return Self().VisitClassDef(static_cast<const ClassDef*>(node));
+            case NodeKind::NamespaceDef: return Self().VisitNamespaceDef(static_cast<const NamespaceDef*>(node));
+            case NodeKind::Import: return Self().VisitImport(static_cast<const Import*>(node));
+            case NodeKind::Var: return Self().VisitVar(static_cast<const Var*>(node));
+            case NodeKind::Assign: return Self().VisitAssign(static_cast<const Assign*>(node));
+            case NodeKind::FunctionCall: return Self().VisitFunctionCall(static_cast<const FunctionCall*>(node));
+            case NodeKind::ObjectCreation: return Self().VisitObjectCreation(static_cast<const ObjectCreation*>(node));
+            case NodeKind::MemberAccess: return Self().VisitMemberAccess(static_cast<const MemberAccess*>(node));
+            case NodeKind::BinOp: return Self().VisitBinOp(static_cast<const BinOp*>(node));
+            case NodeKind::UnOp: return Self().VisitUnOp(static_cast<const UnOp*>(node));
+            case NodeKind::Literal: return Self().VisitLiteral(static_cast<const Literal*>(node));
+        }
+        return Self().VisitNode(node);
+    }
+
+    Result VisitNode(const ASTNode*) { return Result(); }
+
+    Result VisitCompilationUnit(const CompilationUnit* node) { return Self().VisitNode(node); }
+    Result VisitFunctionDef(const FunctionDef* node) { return Self().VisitNode(node); }
+    Result VisitReturn(const Return* node) { return Self().VisitNode(node); }
+    Result VisitDeclare(const Declare* node) { return Self().VisitNode(node); }
+    Result VisitExpStatement(const ExpStatement* node) { return Self().VisitNode(node); }
+    Result VisitClassDef(const ClassDef* node) { return Self().VisitNode(node); }
+    Result VisitNamespaceDef(const NamespaceDef* node) { return Self().VisitNode(node); }
+    Result VisitImport(const Import* node) { return Self().VisitNode(node); }
+    Result VisitVar(const Var* node) { return Self().VisitNode(node); }
+    Result VisitAssign(const Assign* node) { return Self().VisitNode(node); }
+    Result VisitFunctionCall(const FunctionCall* node) { return Self().VisitNode(node); }
+    Result VisitObjectCreation(const ObjectCreation* node) { return Self().VisitNode(node); }
+    Result VisitMemberAccess(const MemberAccess* node) { return Self().VisitNode(node); }
+    Result VisitBinOp(const BinOp* node) { return Self().VisitNode(node); }
+    Result VisitUnOp(const UnOp* node) { return Self().VisitNode(node); }
+    Result VisitLiteral(const Literal* node) { return Self().VisitNode(node); }
+
+private:
+    Derived& Self() { return static_cast<Derived&>(*this); }
+};
+
+#endif //ASTVISITOR_HPP
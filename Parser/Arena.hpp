@@ -0,0 +1,102 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Bump-pointer allocator for AST nodes. Nodes are placement-constructed into
+// large blocks and are never destroyed one by one: the arena frees its
+// blocks when it goes away, so everything stored in it must be trivially
+// destructible apart from the (empty) ASTNode destructor.
+class Arena {
+  public:
+  static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+  explicit Arena(std::size_t blockSize = DefaultBlockSize) : blockSize(blockSize) {}
+  Arena(Arena&&) = default;
+  Arena& operator=(Arena&&) = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void*
+  allocate(std::size_t size, std::size_t alignment) {
+    std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(cursor) % alignment) % alignment;
+    if (cursor == nullptr || padding + size > static_cast<std::size_t>(end - cursor)) {
+      grow(size + alignment);
+      padding = (alignment - reinterpret_cast<std::uintptr_t>(cursor) % alignment) % alignment;
+    }
+    std::byte* result = cursor + padding;
+    cursor = result + size;
+    bytesUsed += padding + size;
+    return result;
+  }
+
+  template <typename T, typename... Args>
+  T*
+  make(Args&&... args) {
+    nodeCount++;
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // Copies scratch[mark..] into the arena as a span of T* and truncates the
+  // scratch stack back to mark. Lets nested child lists share one vector.
+  template <typename T, typename U>
+  std::span<T*>
+  takeTail(std::vector<U*>& scratch, std::size_t mark) {
+    const std::size_t count = scratch.size() - mark;
+    if (count == 0) {
+      return {};
+    }
+    auto* items = static_cast<T**>(allocate(count * sizeof(T*), alignof(T*)));
+    for (std::size_t i = 0; i < count; ++i) {
+      items[i] = static_cast<T*>(scratch[mark + i]);
+    }
+    scratch.resize(mark);
+    return {items, count};
+  }
+
+  [[nodiscard]] std::size_t
+  getNodeCount() const {
+    return nodeCount;
+  }
+
+  [[nodiscard]] std::size_t
+  getBytesUsed() const {
+    return bytesUsed;
+  }
+
+  [[nodiscard]] std::size_t
+  getBytesReserved() const {
+    return bytesReserved;
+  }
+
+  private:
+  std::vector<std::unique_ptr<std::byte[]>> blocks;
+  std::byte* cursor = nullptr;
+  std::byte* end = nullptr;
+  std::size_t blockSize;
+  std::size_t nodeCount = 0;
+  std::size_t bytesUsed = 0;
+  std::size_t bytesReserved = 0;
+
+  void
+  grow(std::size_t minimum) {
+    const std::size_t size = std::max(blockSize, minimum);
+    blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+    cursor = blocks.back().get();
+    end = cursor + size;
+    bytesReserved += size;
+  }
+};
+
+#endif //ARENA_HPP
@@ -5,105 +5,213 @@
 #ifndef EXPRESSIONPARSER_HPP
 #define EXPRESSIONPARSER_HPP
 
+#include <cstdint>
+#include <vector>
 #include "ParserBase.hpp"
 #include "ParsingContext.hpp"
 
+// Operator-precedence (shunting-yard) expression parser. Operands wait on
+// context.scratch and operators on an explicit stack, so nesting depth costs
+// heap, not native stack, and every token is handled once.
 class ExpressionParser : public ParserBase {
 public:
-    std::unique_ptr<Exp> ParseExpression() {
-        return ParseAdditiveExpression();
-    }
     explicit ExpressionParser(ParsingContext& context) : ParserBase(context) {}
 
-private:
-    std::unique_ptr<Exp> ParseAdditiveExpression() {
-        auto left = ParseMultiplicativeExpression();
-        while ( (context.currentToken.raw_val == "+" || context.currentToken.raw_val == "-")) {
-            BinaryOperator op = (context.currentToken.raw_val == "+") ? BinaryOperator::Add : BinaryOperator::Sub;
-            context.advance();
-            auto right = ParseMultiplicativeExpression();
-            left = std::make_unique<BinOp>(op, std::move(left), std::move(right));
+    Exp* ParseExpression() {
+        const std::size_t operandMark = context.scratch.size();
+        const std::size_t operatorMark = operators.size();
+        bool expectOperand = true;
+
+        while (true) {
+            if (expectOperand) {
+                expectOperand = ParseOperandPrefix();
+                continue;
+            }
+            const TokenKind kind = context.kind();
+            if (const int precedence = BinaryPrecedence(kind); precedence > 0) {
+                ReduceWhile(operatorMark, precedence);
+                operators.push_back({BinaryOperation(kind), precedence});
+                context.advance();
+                expectOperand = true;
+                continue;
+            }
+            if (kind == TokenKind::TK_CLOSE_PAREN && HasOpenGroup(operatorMark)) {
+                ReduceWhile(operatorMark, 1);
+                CloseGroup();
+                context.advance();
+                continue;
+            }
+            if (kind == TokenKind::TK_COMMA && HasOpenGroup(operatorMark)) {
+                ReduceWhile(operatorMark, 1);
+                if (operators.back().op == Operation::Call) {
+                    context.advance();
+                    expectOperand = true;
+                    continue;
+                }
+            }
+            break;
         }
-        return left;
+
+        ReduceWhile(operatorMark, 1);
+        if (operators.size() != operatorMark) {
+            // A '(' or call was never closed.
+            Expect(TokenKind::TK_CLOSE_PAREN);
+        }
+        Exp* result = static_cast<Exp*>(context.scratch.back());
+        context.scratch.resize(operandMark);
+        return result;
     }
 
-    std::unique_ptr<Exp> ParseMultiplicativeExpression() {
-        auto left = ParseUnaryExpression();
-        while (context.currentToken.raw_val == "*" || context.currentToken.raw_val == "/") {
-            BinaryOperator op = (context.currentToken.raw_val == "*") ? BinaryOperator::Mul : BinaryOperator::Div;
-            context.advance();
-            auto right = ParseUnaryExpression();
-            left = std::make_unique<BinOp>(op, std::move(left), std::move(right));
+private:
+    enum class Operation : std::uint8_t { Add, Sub, Mul, Div, Neg, Group, Call };
+    static constexpr int PrefixPrecedence = 3;
+
+    struct PendingOperator {
+        Operation op;
+        int precedence;
+        // Call only: callee and where its arguments start on the operand stack.
+        SymbolId name = InvalidSymbol;
+        std::size_t argumentMark = 0;
+    };
+    std::vector<PendingOperator> operators;
+
+    static int BinaryPrecedence(TokenKind kind) {
+        switch (kind) {
+            case TokenKind::TK_PLUS:
+            case TokenKind::TK_MINUS: return 1;
+            case TokenKind::TK_ASTERISK:
+            case TokenKind::TK_SLASH: return 2;
+            default: return 0;
         }
-        return left;
     }
 
-    std::unique_ptr<Exp> ParseUnaryExpression() {
-        if (context.currentToken.raw_val == "-") {
-            context.advance();
-            auto operand = ParseUnaryExpression();
-            return std::make_unique<UnOp>(UnaryOperator::Neg, std::move(operand));
+    static Operation BinaryOperation(TokenKind kind) {
+        switch (kind) {
+            case TokenKind::TK_PLUS: return Operation::Add;
+            case TokenKind::TK_MINUS: return Operation::Sub;
+            case TokenKind::TK_ASTERISK: return Operation::Mul;
+            default: return Operation::Div;
         }
-        return ParsePrimaryExpression();
     }
 
-    std::unique_ptr<Exp> ParsePrimaryExpression() {
-        if (context.currentToken.kind == TokenKind::TK_INT) {
-            int value = std::stoi(context.currentToken.raw_val);
-            context.advance();
-            return std::make_unique<Literal>(value);
+    // Consumes one prefix item where an operand is expected. Returns whether
+    // an operand is still expected afterwards.
+    bool ParseOperandPrefix() {
+        switch (context.kind()) {
+            case TokenKind::TK_MINUS:
+                operators.push_back({Operation::Neg, PrefixPrecedence});
+                context.advance();
+                return true;
+            case TokenKind::TK_OPEN_PAREN:
+                operators.push_back({Operation::Group, 0});
+                context.advance();
+                return true;
+            case TokenKind::TK_INT:
+                context.scratch.push_back(Make<Literal>(Lexer::parseIntLiteral(context.text())));
+                context.advance();
+                return false;
+            case TokenKind::TK_IDENTIFIER:
+                return ParseNameOperand();
+            default:
+                throw std::runtime_error("Unexpected token in primary expression in line: " + std::to_string(context.getCurrentLine()));
         }
-        if (context.currentToken.kind == TokenKind::TK_IDENTIFIER) {
-            std::string name = context.currentToken.raw_val;
+    }
+
+    bool ParseNameOperand() {
+        SymbolId name = context.symbol();
+        context.advance();
+        if (context.kind() == TokenKind::TK_OPEN_PAREN) {
+            // Function call or object creation
             context.advance();
-            if (context.currentToken.raw_val == "(") {
-                // Function call or object creation
-                return ParseFunctionOrObjectCreation(std::move(name));
+            operators.push_back({Operation::Call, 0, name, context.scratch.size()});
+            if (context.kind() == TokenKind::TK_CLOSE_PAREN) {
+                CloseGroup();
+                context.advance();
+                return false;
             }
-            if (context.currentToken.raw_val == ".") {
-                // Member access
-                return ParseMemberAccess(std::make_unique<Var>(std::move(name)));
+            return true;
+        }
+        if (context.kind() == TokenKind::TK_DOT) {
+            // Member access
+            context.scratch.push_back(ParseMemberAccess(Make<Var>(name)));
+            return false;
+        }
+        context.scratch.push_back(Make<Var>(name));
+        return false;
+    }
+
+    [[nodiscard]] bool HasOpenGroup(std::size_t operatorMark) const {
+        for (std::size_t i = operators.size(); i > operatorMark; --i) {
+            const Operation op = operators[i - 1].op;
+            if (op == Operation::Group || op == Operation::Call) {
+                return true;
             }
-            return std::make_unique<Var>(std::move(name));
         }
-        if (context.currentToken.raw_val == "(") {
-            context.advance();
-            auto exp = ParseExpression();
-            Expect(")");
-            return exp;
+        return false;
+    }
+
+    // Applies stacked operators that bind at least as tightly as precedence
+    // (all operators are left associative, prefix minus binds tightest).
+    void ReduceWhile(std::size_t operatorMark, int precedence) {
+        while (operators.size() > operatorMark) {
+            const PendingOperator top = operators.back();
+            if (top.op == Operation::Group || top.op == Operation::Call || top.precedence < precedence) {
+                return;
+            }
+            operators.pop_back();
+            Exp* rhs = PopOperand();
+            if (top.op == Operation::Neg) {
+                context.scratch.push_back(Make<UnOp>(UnaryOperator::Neg, rhs));
+                continue;
+            }
+            Exp* lhs = PopOperand();
+            context.scratch.push_back(Make<BinOp>(ToBinaryOperator(top.op), lhs, rhs));
         }
-        throw std::runtime_error("Unexpected token in primary expression in line: " + std::to_string(context.getCurrentLine()));
     }
 
-    std::unique_ptr<Exp> ParseFunctionOrObjectCreation(std::string name) {
-        Expect("(");
-        std::vector<std::unique_ptr<Exp>> arguments;
-        if (context.currentToken.raw_val != ")") {
-            do {
-                arguments.push_back(ParseExpression());
-            } while (context.currentToken.raw_val == "," && (context.advance(), true));
+    // Closes the innermost '(' group or call; its operands are already reduced.
+    void CloseGroup() {
+        const PendingOperator group = operators.back();
+        operators.pop_back();
+        if (group.op == Operation::Group) {
+            return;
         }
-        Expect(")");
-        if (IsTypeName(name)) {
+        auto arguments = context.arena->takeTail<Exp>(context.scratch, group.argumentMark);
+        if (IsTypeName(group.name)) {
             // Object creation
-            return std::make_unique<ObjectCreation>(std::move(name), std::move(arguments));
+            context.scratch.push_back(Make<ObjectCreation>(group.name, arguments));
         } else {
             // Function call
-            return std::make_unique<FunctionCall>(std::move(name), std::move(arguments));
+            context.scratch.push_back(Make<FunctionCall>(group.name, arguments));
         }
     }
 
-    std::unique_ptr<Exp> ParseMemberAccess(std::unique_ptr<Exp> object) {
-        Expect(".");
-        std::string memberName = context.currentToken.raw_val;
-        context.advance();
-        return std::make_unique<MemberAccess>(std::move(object), std::move(memberName));
+    Exp* PopOperand() {
+        Exp* operand = static_cast<Exp*>(context.scratch.back());
+        context.scratch.pop_back();
+        return operand;
+    }
+
+    static BinaryOperator ToBinaryOperator(Operation op) {
+        switch (op) {
+            case Operation::Add: return BinaryOperator::Add;
+            case Operation::Sub: return BinaryOperator::Sub;
+            case Operation::Mul: return BinaryOperator::Mul;
+            default: return BinaryOperator::Div;
+        }
+    }
+
+    Exp* ParseMemberAccess(Exp* object) {
+        Expect(TokenKind::TK_DOT);
+        SymbolId memberName = ExpectIdentifier();
+        return Make<MemberAccess>(object, memberName);
     }
 
-    static bool IsTypeName(const std::string& name) {
+    static bool IsTypeName(SymbolId name) {
         // Implement logic to check if 'name' is a type name (e.g., class or built-in type)
         // For simplicity, let's assume any name starting with a capital letter is a type
-        return !name.empty() && std::isupper(name[0]);
+        const std::string_view spelling = Interner::spelling(name);
+        return !spelling.empty() && std::isupper(static_cast<unsigned char>(spelling[0]));
     }
 };
 
@@ -12,31 +12,47 @@ class FunctionParser : public ParserBase {
   public:
   explicit FunctionParser(ParsingContext& context) : ParserBase(context), statementParser(context) {}
 
-  std::unique_ptr<FunctionDef>
+  FunctionDef*
   ParseFunction() {
-    std::string name = context.currentToken.raw_val;
+    SymbolId name = context.symbol();
     context.advance();
 
-    Expect("::");
-    Expect("(");
-    Expect(")");
-    std::string returnType = context.currentToken.raw_val;
+    Expect(TokenKind::TK_COLONCOLON);
+    Expect(TokenKind::TK_OPEN_PAREN);
+    const std::span<Declare*> parameters = ParseParameters();
+    SymbolId returnType = context.symbol();
     context.advance();
-    Expect("{");
-
-    int allocationSize = 0;
-    std::vector<std::unique_ptr<Statement>> statements;
-    while (context.currentToken.raw_val != "}") {
-      auto statement = statementParser.ParseStatement();
-      if (auto declare = dynamic_cast<Declare*>(statement.get())) {
-        if (declare->type == "int") {
-          allocationSize += 16; // Assuming int is 16 bytes as per original code
-        }
+    Expect(TokenKind::TK_OPEN_BRACE);
+
+    const std::size_t mark = context.scratch.size();
+    while (context.kind() != TokenKind::TK_CLOSE_BRACE && context.kind() != TokenKind::TK_EOF) {
+      context.scratch.push_back(statementParser.ParseStatement());
+    }
+    Expect(TokenKind::TK_CLOSE_BRACE);
+    auto statements = context.arena->takeTail<Statement>(context.scratch, mark);
+    return Make<FunctionDef>(name, parameters, returnType, statements);
+  }
+
+  private:
+  // name: int {, name: int} ) -- the opening parenthesis is already consumed.
+  std::span<Declare*>
+  ParseParameters() {
+    const std::size_t mark = context.scratch.size();
+    while (context.kind() != TokenKind::TK_CLOSE_PAREN) {
+      if (context.scratch.size() > mark) {
+        Expect(TokenKind::TK_COMMA);
+      }
+      SymbolId name = ExpectIdentifier();
+      Expect(TokenKind::TK_COLON);
+      if (context.kind() != TokenKind::TK_KW_INT) {
+        throw std::runtime_error("Parameter type not in system types in line: " + std::to_string(context.getCurrentLine()));
       }
-      statements.push_back(std::move(statement));
+      SymbolId type = context.symbol();
+      context.advance();
+      context.scratch.push_back(Make<Declare>(name, type));
     }
-    Expect("}");
-    return std::make_unique<FunctionDef>(std::move(name), allocationSize,std::move(returnType), std::move(statements));
+    context.advance();
+    return context.arena->takeTail<Declare>(context.scratch, mark);
   }
 };
 
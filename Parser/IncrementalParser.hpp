@@ -0,0 +1,351 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef INCREMENTALPARSER_HPP
+#define INCREMENTALPARSER_HPP
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Parser.cpp"
+
+// Front end for a document that is edited in place, as in an editor.
+//
+// The text is kept as a sequence of chunks. A chunk starts at the beginning
+// of a line and holds one or more complete top-level items (functions,
+// classes, statements) plus the blank space after them. An edit relexes and
+// reparses only the chunks it touches, growing the range while the last item
+// is still open (an unbalanced '{'). Every other chunk keeps its text, tokens
+// and subtrees; the ones after the edit only have their line number shifted.
+// The result of an edit is the same as parsing the new text from scratch.
+class IncrementalParser {
+  public:
+  // 1-based line and 0-based column, like the lexer's.
+  struct Diagnostic {
+    int line;
+    int column;
+    std::string message;
+  };
+
+  explicit IncrementalParser(std::string name, std::string_view text = {}) : name(std::move(name)) {
+    Replace(text);
+  }
+
+  // Throws the whole document away and parses text from scratch.
+  void
+  Replace(std::string_view text) {
+    chunks = Build(std::string(text), 1);
+    lastRebuiltChunks = chunks.size();
+  }
+
+  // Replaces the text between two positions (0-based line, 0-based byte
+  // column) with text. Positions past the end of a line or of the document
+  // are clamped to it.
+  void
+  Edit(int startLine, int startColumn, int endLine, int endColumn, std::string_view text) {
+    const auto [first, startOffset] = Locate(startLine + 1, startColumn);
+    auto [last, endOffset] = Locate(endLine + 1, endColumn);
+    if (last < first || (last == first && endOffset < startOffset)) {
+      last = first;
+      endOffset = startOffset;
+    }
+    // Chunks strictly between first and last lie inside the replaced range.
+    std::string region(ChunkText(chunks[first]).substr(0, startOffset));
+    region += text;
+    region += ChunkText(chunks[last]).substr(endOffset);
+    ReplaceChunks(first, last + 1, std::move(region));
+  }
+
+  [[nodiscard]] std::vector<Diagnostic>
+  Diagnostics() const {
+    std::vector<Diagnostic> diagnostics;
+    for (const Chunk& chunk : chunks) {
+      if (chunk.error) {
+        diagnostics.push_back(*chunk.error);
+      }
+    }
+    return diagnostics;
+  }
+
+  // Top-level nodes of the whole document, in source order. Items with a
+  // syntax error are left out.
+  [[nodiscard]] std::vector<const ASTNode*>
+  Nodes() const {
+    std::vector<const ASTNode*> nodes;
+    for (const Chunk& chunk : chunks) {
+      nodes.insert(nodes.end(), chunk.nodes.begin(), chunk.nodes.end());
+    }
+    return nodes;
+  }
+
+  [[nodiscard]] std::string
+  Text() const {
+    std::string text;
+    for (const Chunk& chunk : chunks) {
+      text += ChunkText(chunk);
+    }
+    return text;
+  }
+
+  [[nodiscard]] std::size_t
+  getChunkCount() const {
+    return chunks.size();
+  }
+
+  // Chunks lexed and parsed by the last Replace or Edit.
+  [[nodiscard]] std::size_t
+  getLastRebuiltChunks() const {
+    return lastRebuiltChunks;
+  }
+
+  private:
+  // Text, tokens and nodes of one lexed range. Shared by the chunks cut from
+  // it and freed with the last of them.
+  struct Segment {
+    std::string text;
+    TokenBuffer tokens;
+    Arena arena;
+    explicit Segment(std::string source)
+      : text(std::move(source)), arena(std::clamp<std::size_t>(text.size() * 2, 1024, Arena::DefaultBlockSize)) {}
+  };
+
+  struct Chunk {
+    std::shared_ptr<Segment> segment;
+    std::size_t textBegin;
+    std::size_t textEnd;
+    int firstLine;  // 1-based line of textBegin in the document
+    int lineBreaks; // newlines in the chunk's text
+    std::span<ASTNode*> nodes;
+    std::optional<Diagnostic> error; // first syntax error in the chunk
+  };
+
+  // Token range of one top-level item; open when it is never terminated.
+  struct Item {
+    std::size_t begin;
+    std::size_t end;
+    bool open;
+  };
+
+  std::string name;
+  std::vector<Chunk> chunks;
+  std::size_t lastRebuiltChunks = 0;
+
+  static std::string_view
+  ChunkText(const Chunk& chunk) {
+    return std::string_view(chunk.segment->text).substr(chunk.textBegin, chunk.textEnd - chunk.textBegin);
+  }
+
+  static int
+  LineBreaks(std::string_view text) {
+    return static_cast<int>(std::ranges::count(text, '\n'));
+  }
+
+  // Chunk containing a (1-based line, column) position and the byte offset
+  // of that position within the chunk's text.
+  [[nodiscard]] std::pair<std::size_t, std::size_t>
+  Locate(int line, int column) const {
+    auto after = std::upper_bound(chunks.begin(), chunks.end(), line,
+      [](int target, const Chunk& chunk) { return target < chunk.firstLine; });
+    const std::size_t index = after == chunks.begin() ? 0 : static_cast<std::size_t>(after - chunks.begin()) - 1;
+    const std::string_view text = ChunkText(chunks[index]);
+    std::size_t offset = 0;
+    for (int skip = line - chunks[index].firstLine; skip > 0; --skip) {
+      const std::size_t newline = text.find('\n', offset);
+      if (newline == std::string_view::npos) {
+        return {index, text.size()};
+      }
+      offset = newline + 1;
+    }
+    const std::size_t lineEnd = std::min(text.find('\n', offset), text.size());
+    return {index, std::min(offset + static_cast<std::size_t>(std::max(column, 0)), lineEnd)};
+  }
+
+  // Rebuilds chunks [first, end) from region, pulling in following chunks
+  // while the rest of the document depends on it, then shifts the lines
+  // after it.
+  void
+  ReplaceChunks(std::size_t first, std::size_t end, std::string region) {
+    int oldLineBreaks = 0;
+    for (std::size_t i = first; i < end; ++i) {
+      oldLineBreaks += chunks[i].lineBreaks;
+    }
+
+    std::vector<Chunk> rebuilt;
+    for (std::size_t absorb = 1;; absorb *= 2) {
+      bool open = false;
+      rebuilt = Build(region, chunks[first].firstLine, &open);
+      if (!open || end == chunks.size()) {
+        break;
+      }
+      // Doubling keeps an unmatched '{' linear in the text it swallows.
+      for (const std::size_t stop = std::min(chunks.size(), end + absorb); end < stop; ++end) {
+        region += ChunkText(chunks[end]);
+        oldLineBreaks += chunks[end].lineBreaks;
+      }
+    }
+
+    int newLineBreaks = 0;
+    for (const Chunk& chunk : rebuilt) {
+      newLineBreaks += chunk.lineBreaks;
+    }
+    lastRebuiltChunks = rebuilt.size();
+    const std::size_t after = first + rebuilt.size();
+    Splice(first, end, std::move(rebuilt));
+
+    const int delta = newLineBreaks - oldLineBreaks;
+    if (delta == 0) {
+      return;
+    }
+    for (std::size_t i = after; i < chunks.size(); ++i) {
+      chunks[i].firstLine += delta;
+      if (chunks[i].error) {
+        // Messages name their line, so a moved error is parsed again.
+        std::vector<Chunk> moved = Build(std::string(ChunkText(chunks[i])), chunks[i].firstLine);
+        const std::size_t count = moved.size();
+        lastRebuiltChunks += count;
+        Splice(i, i + 1, std::move(moved));
+        i += count - 1;
+      }
+    }
+  }
+
+  // Replaces chunks [first, end) with replacement, shifting the tail of the
+  // vector at most once (not at all when the count is unchanged).
+  void
+  Splice(std::size_t first, std::size_t end, std::vector<Chunk> replacement) {
+    const auto at = [&](std::size_t index) { return chunks.begin() + static_cast<std::ptrdiff_t>(index); };
+    const std::size_t count = replacement.size();
+    if (count < end - first) {
+      chunks.erase(at(first + count), at(end));
+    } else if (count > end - first) {
+      chunks.insert(at(end), std::make_move_iterator(replacement.begin() + static_cast<std::ptrdiff_t>(end - first)),
+                    std::make_move_iterator(replacement.end()));
+    }
+    std::move(replacement.begin(), replacement.begin() + static_cast<std::ptrdiff_t>(std::min(count, end - first)), at(first));
+  }
+
+  // Splits a token stream into top-level items: an item ends at a ';' outside
+  // braces or at the '}' that closes its outermost brace.
+  static std::vector<Item>
+  SplitItems(const TokenBuffer& tokens) {
+    using enum TokenKind;
+    std::vector<Item> items;
+    const std::size_t eof = tokens.size() - 1;
+    std::size_t begin = 0;
+    int depth = 0;
+    for (std::size_t i = 0; i < eof; ++i) {
+      const TokenKind kind = tokens.kinds[i];
+      if (kind == TK_OPEN_BRACE) {
+        depth++;
+      } else if ((kind == TK_SEMICOLON && depth == 0) || (kind == TK_CLOSE_BRACE && --depth <= 0)) {
+        items.push_back({begin, i + 1, false});
+        begin = i + 1;
+        depth = 0;
+      }
+    }
+    if (begin < eof) {
+      items.push_back({begin, eof, true});
+    }
+    return items;
+  }
+
+  // Lexes and parses text, which starts at the beginning of line firstLine,
+  // into chunks. Sets *open when the text after it would parse differently
+  // on its own: the last item is unterminated, or a lexer error ends the
+  // tokens, which leaves the rest of the document without any.
+  std::vector<Chunk>
+  Build(std::string text, int firstLine, bool* open = nullptr) {
+    auto segment = std::make_shared<Segment>(std::move(text));
+    const std::string_view source = segment->text;
+    const TokenBuffer& tokens = segment->tokens;
+    std::vector<Chunk> built;
+    built.push_back({segment, 0, source.size(), firstLine, 0, {}, std::nullopt});
+
+    Lexer lexer(source, name, firstLine);
+    try {
+      segment->tokens = TokenBuffer::Tokenize(lexer);
+    } catch (const std::runtime_error& error) {
+      // Items before the bad line still parse, except the chunk of one that
+      // runs into it. From there on there are no tokens, so the rest of the
+      // document is one chunk until the error is edited away.
+      const int line = lexer.getCurrentLine();
+      std::size_t lineStart = 0;
+      for (int skip = line - firstLine; skip > 0; --skip) {
+        lineStart = source.find('\n', lineStart) + 1;
+      }
+      bool prefixOpen = false;
+      built.clear();
+      if (lineStart > 0) {
+        built = Build(std::string(source.substr(0, lineStart)), firstLine, &prefixOpen);
+      }
+      if (prefixOpen) {
+        lineStart = built.back().textBegin;
+        built.pop_back();
+      }
+      const int chunkLine = firstLine + LineBreaks(source.substr(0, lineStart));
+      built.push_back({segment, lineStart, source.size(), chunkLine, LineBreaks(source.substr(lineStart)), {},
+        Diagnostic{line, std::max(lexer.getCurrentPosition() - 1, 0), error.what()}});
+      if (open != nullptr) {
+        *open = true;
+      }
+      return built;
+    }
+
+    const std::vector<Item> items = SplitItems(tokens);
+    if (open != nullptr) {
+      *open = !items.empty() && items.back().open;
+    }
+
+    ParsingContext context(tokens);
+    context.arena = &segment->arena;
+    StatementParser statementParser(context);
+    FunctionParser functionParser(context);
+
+    std::size_t previousEnd = 0;
+    bool chunkHasItem = false;
+    for (const Item& item : items) {
+      // Start a new chunk at the item's line unless the previous item ends
+      // on that line.
+      const std::size_t offset = tokens.offsets[item.begin];
+      const std::size_t lineStart = offset == 0 ? 0 : source.rfind('\n', offset - 1) + 1;
+      if (chunkHasItem && lineStart >= previousEnd) {
+        CloseChunk(built.back(), lineStart, context);
+        const int line = built.back().firstLine + built.back().lineBreaks;
+        built.push_back({segment, lineStart, source.size(), line, 0, {}, std::nullopt});
+      }
+      chunkHasItem = true;
+
+      const std::size_t mark = context.scratch.size();
+      context.index = item.begin;
+      context.end = item.end;
+      try {
+        if (Parser::IsFunctionDefinition(tokens, item.begin)) {
+          context.scratch.push_back(functionParser.ParseFunction());
+        } else {
+          context.scratch.push_back(statementParser.ParseStatement());
+        }
+      } catch (const std::runtime_error& error) {
+        context.scratch.resize(mark);
+        if (!built.back().error) {
+          built.back().error = Diagnostic{context.getCurrentLine(), context.getCurrentPosition(), error.what()};
+        }
+      }
+      previousEnd = tokens.offsets[item.end - 1] + tokens.lengths[item.end - 1];
+    }
+    CloseChunk(built.back(), source.size(), context);
+    return built;
+  }
+
+  static void
+  CloseChunk(Chunk& chunk, std::size_t textEnd, ParsingContext& context) {
+    chunk.textEnd = textEnd;
+    chunk.lineBreaks = LineBreaks(ChunkText(chunk));
+    chunk.nodes = context.arena->takeTail<ASTNode>(context.scratch, 0);
+  }
+};
+
+#endif //INCREMENTALPARSER_HPP
@@ -0,0 +1,47 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef PARALLELFOR_HPP
+#define PARALLELFOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Small fixed pool: `workers` threads (the caller is worker 0) pull item
+// indices from a shared counter until all `count` items are done, then the
+// pool is joined. task(worker, item) must not throw; worker is a stable index
+// below `workers`, so callers can keep per-worker state without locking.
+template <typename Task>
+void
+ParallelFor(unsigned workers, std::size_t count, Task&& task) {
+  workers = static_cast<unsigned>(std::clamp<std::size_t>(workers, 1, std::max<std::size_t>(count, 1)));
+  std::atomic<std::size_t> next{0};
+  auto drain = [&](unsigned worker) {
+    for (std::size_t item = next.fetch_add(1, std::memory_order_relaxed); item < count;
+         item = next.fetch_add(1, std::memory_order_relaxed)) {
+      task(worker, item);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (unsigned worker = 1; worker < workers; ++worker) {
+    threads.emplace_back(drain, worker);
+  }
+  drain(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Thread count used when the caller does not pick one.
+inline unsigned
+DefaultThreadCount() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+#endif //PARALLELFOR_HPP
@@ -3,52 +3,163 @@
 #ifndef PARSER_CPP
 #define PARSER_CPP
 
-#include <optional>
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <memory>
 #include <vector>
 #include "../Lexer/Lexer.cpp"
 #include "ParserTypes.hpp"
 #include "StatementParser.hpp"
 #include "FunctionParser.hpp"
 #include "ParsingContext.hpp"
+#include "ParallelFor.hpp"
 
 class Parser {
   public:
-  explicit Parser(Lexer& lexer) : context(lexer), statementParser(context), functionParser(context) {}
+  explicit Parser(Lexer& lexer)
+    : path(lexer.getPath()), tokens(TokenBuffer::Tokenize(lexer)), context(tokens), statementParser(context), functionParser(context) {}
+
+  // Threads used for function bodies; 1 parses everything on the calling thread.
+  void setThreadCount(unsigned count) {
+    threadCount = std::max(1u, count);
+  }
 
   std::unique_ptr<CompilationUnit> parseUnit() {
-    std::vector<std::unique_ptr<ASTNode>> nodes;
-    while (context.currentToken.kind != TokenKind::TK_EOF) {
-      if (IsFunctionDefinition()) {
-        nodes.push_back(functionParser.ParseFunction());
-      } else {
-        nodes.push_back(statementParser.ParseStatement());
+    auto unit = std::make_unique<CompilationUnit>();
+    const std::vector<TokenRange> functions = FindTopLevelFunctions(tokens);
+    std::vector<FunctionDef*> definitions(functions.size());
+    std::vector<std::exception_ptr> errors(functions.size());
+    ParseFunctions(*unit, functions, definitions, errors);
+
+    // Everything between the function bodies is parsed here, and each
+    // definition is spliced in at its source position. Errors are rethrown in
+    // source order, so the result does not depend on the thread count.
+    context.arena = &unit->arena;
+    context.index = 0;
+    const std::size_t mark = context.scratch.size();
+    for (std::size_t i = 0; i <= functions.size(); ++i) {
+      const std::size_t stop = i < functions.size() ? functions[i].begin : tokens.size();
+      while (context.index < stop && context.kind() != TokenKind::TK_EOF) {
+        if (IsFunctionDefinition(tokens, context.index)) {
+          context.scratch.push_back(functionParser.ParseFunction());
+        } else {
+          context.scratch.push_back(statementParser.ParseStatement());
+        }
+      }
+      if (i < functions.size()) {
+        if (errors[i]) {
+          std::rethrow_exception(errors[i]);
+        }
+        context.scratch.push_back(definitions[i]);
+        context.index = functions[i].end;
       }
     }
-    return std::make_unique<CompilationUnit>(std::move(nodes));
+    unit->nodes = unit->arena.takeTail<ASTNode>(context.scratch, mark);
+    context.arena = nullptr;
+    return unit;
   }
 
-  private:
-  ParsingContext context;
-  StatementParser statementParser;
-  FunctionParser functionParser;
+  // Prints the nodes and arena bytes unit took, worker arenas included.
+  void reportArena(const CompilationUnit& unit, std::ostream& out) const {
+    std::size_t nodes = unit.arena.getNodeCount(), used = unit.arena.getBytesUsed(), reserved = unit.arena.getBytesReserved();
+    for (const Arena& arena : unit.workerArenas) {
+      nodes += arena.getNodeCount();
+      used += arena.getBytesUsed();
+      reserved += arena.getBytesReserved();
+    }
+    out << std::format("Parsed {} AST nodes into {} arena bytes ({} reserved) for file {}\n", nodes, used, reserved, path);
+  }
 
-  bool IsFunctionDefinition() {
-    if (context.currentToken.kind != TokenKind::TK_IDENTIFIER || context.addNextTokenToDequeue().kind != TokenKind::TK_COLONCOLON) {
+  // name :: static ... | name :: () ... | name :: (param: ...
+  [[nodiscard]] static bool IsFunctionDefinition(const TokenBuffer& tokens, std::size_t at) {
+    using enum TokenKind;
+    auto peek = [&](std::size_t n) { return at + n < tokens.size() ? tokens.kinds[at + n] : TK_EOF; };
+    if (peek(0) != TK_IDENTIFIER || peek(1) != TK_COLONCOLON) {
       return false;
     }
-    if (context.addNextTokenToDequeue().raw_val == "static") {
+    if (peek(2) == TK_KW_STATIC) {
       return true;
     }
-    if (context.getLastTokenFromQueue().kind != TokenKind::TK_OPEN_PAREN) {
+    if (peek(2) != TK_OPEN_PAREN) {
       return false;
     }
-    if (context.addNextTokenToDequeue().kind == TokenKind::TK_CLOSE_PAREN) {
-      return true;
+    return peek(3) == TK_CLOSE_PAREN || (peek(3) == TK_IDENTIFIER && peek(4) == TK_COLON);
+  }
+
+  private:
+  // Tokens [begin, end) of one top-level function definition, closing brace included.
+  struct TokenRange {
+    std::size_t begin;
+    std::size_t end;
+  };
+  // Below this many functions per thread, extra threads cost more than they save.
+  static constexpr std::size_t MinFunctionsPerThread = 16;
+
+  std::string path;
+  TokenBuffer tokens;
+  ParsingContext context;
+  StatementParser statementParser;
+  FunctionParser functionParser;
+  unsigned threadCount = DefaultThreadCount();
+
+  // Pre-pass over the token kinds: finds each function definition at brace
+  // depth 0 and its extent by brace matching, without building any nodes.
+  // Stops at an unterminated body and leaves the rest to the sequential
+  // parser, which reports the error.
+  static std::vector<TokenRange> FindTopLevelFunctions(const TokenBuffer& tokens) {
+    using enum TokenKind;
+    std::vector<TokenRange> ranges;
+    const std::vector<TokenKind>& kinds = tokens.kinds;
+    std::size_t depth = 0;
+    for (std::size_t i = 0; i < kinds.size(); ++i) {
+      if (kinds[i] == TK_OPEN_BRACE) {
+        depth++;
+      } else if (kinds[i] == TK_CLOSE_BRACE) {
+        depth -= depth > 0;
+      } else if (depth == 0 && IsFunctionDefinition(tokens, i)) {
+        std::size_t close = i;
+        while (close < kinds.size() && kinds[close] != TK_OPEN_BRACE) {
+          close++;
+        }
+        for (std::size_t open = 0; close < kinds.size(); ++close) {
+          if (kinds[close] == TK_OPEN_BRACE) {
+            open++;
+          } else if (kinds[close] == TK_CLOSE_BRACE && --open == 0) {
+            break;
+          }
+        }
+        if (close == kinds.size()) {
+          break;
+        }
+        ranges.push_back({i, close + 1});
+        i = close;
+      }
     }
-    if (context.addNextTokenToDequeue().kind == TokenKind::TK_IDENTIFIER && context.addNextTokenToDequeue().kind == TokenKind::TK_COLON) {
-      return true;
+    return ranges;
+  }
+
+  // Parses every range with its own context, parser and arena per thread.
+  void ParseFunctions(CompilationUnit& unit, const std::vector<TokenRange>& functions,
+                      std::vector<FunctionDef*>& definitions, std::vector<std::exception_ptr>& errors) const {
+    const auto threads = static_cast<unsigned>(std::clamp<std::size_t>(functions.size() / MinFunctionsPerThread, 1, threadCount));
+    unit.workerArenas.resize(threads);
+    std::vector<std::unique_ptr<ParsingContext>> contexts;
+    std::vector<std::unique_ptr<FunctionParser>> parsers;
+    for (unsigned worker = 0; worker < threads; ++worker) {
+      contexts.push_back(std::make_unique<ParsingContext>(tokens));
+      contexts.back()->arena = &unit.workerArenas[worker];
+      parsers.push_back(std::make_unique<FunctionParser>(*contexts.back()));
     }
-    return false;
+    ParallelFor(threads, functions.size(), [&](unsigned worker, std::size_t item) {
+      contexts[worker]->index = functions[item].begin;
+      try {
+        definitions[item] = parsers[worker]->ParseFunction();
+      } catch (...) {
+        errors[item] = std::current_exception();
+      }
+    });
   }
 
 };
@@ -5,12 +5,8 @@
 #ifndef PARSERBASE_HPP
 #define PARSERBASE_HPP
 
-#include <memory>
-#include <optional>
 #include <string>
-#include <vector>
 #include <utility>
-#include "../Lexer/Lexer.cpp"
 #include "ParserTypes.hpp"
 #include "ParsingContext.hpp"
 
@@ -18,13 +14,27 @@ class ParserBase {
     protected:
     ParsingContext& context;
 
-    void Expect(const std::string_view expected) {
-        if (context.currentToken.raw_val != expected) {
-            throw std::runtime_error("Expected '" + std::string(expected) + "', but got '" + (context.currentToken.kind == TokenKind::TK_EOF ? context.currentToken.raw_val : "<EOF>") + "' in line: " + std::to_string(context.getCurrentLine()) + " and position: " + std::to_string(context.getCurrentPosition())+'\n');
+    void Expect(const TokenKind expected) {
+        if (context.kind() != expected) {
+            throw std::runtime_error("Expected '" + std::string(tokenKindSpelling(expected)) + "', but got '" + (context.kind() != TokenKind::TK_EOF ? std::string(context.text()) : "<EOF>") + "' in line: " + std::to_string(context.getCurrentLine()) + " and position: " + std::to_string(context.getCurrentPosition())+'\n');
         }
         context.advance();
     }
 
+    template <typename T, typename... Args>
+    T* Make(Args&&... args) {
+        return context.arena->make<T>(std::forward<Args>(args)...);
+    }
+
+    SymbolId ExpectIdentifier() {
+        if (context.kind() != TokenKind::TK_IDENTIFIER) {
+            throw std::runtime_error("Expected identifier, but got '" + std::string(context.text()) + "' in line: " + std::to_string(context.getCurrentLine()) + " and position: " + std::to_string(context.getCurrentPosition())+'\n');
+        }
+        const SymbolId symbol = context.symbol();
+        context.advance();
+        return symbol;
+    }
+
     public:
     explicit ParserBase(ParsingContext& context) : context(context) {}
 };
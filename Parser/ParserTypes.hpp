@@ -5,135 +5,209 @@
 #ifndef PARSERTYPES_HPP
 #define PARSERTYPES_HPP
 
-#include <string>
+#include <cstdint>
+#include <span>
 #include <vector>
-#include <memory>
-#include <optional>
+#include "../Lexer/Interner.hpp"
+#include "Arena.hpp"
+
+// AST nodes live in the CompilationUnit's Arena: children are plain pointers
+// and child lists are arena-resident spans. Nodes are never destroyed
+// individually, so they must not own heap memory.
+
+// Concrete node type tag. Statement and expression kinds are contiguous so
+// the abstract bases can be tested with a range check.
+enum class NodeKind : std::uint8_t {
+    CompilationUnit,
+    FunctionDef,
+    // Statements
+    Return,
+    Declare,
+    ExpStatement,
+    ClassDef,
+    NamespaceDef,
+    Import,
+    // Expressions
+    Var,
+    Assign,
+    FunctionCall,
+    ObjectCreation,
+    MemberAccess,
+    BinOp,
+    UnOp,
+    Literal,
+};
 
 // Base AST Node
 struct ASTNode {
-    virtual ~ASTNode() = default;
+    const NodeKind kind;
+
+    // node->as<T>() is the node as a T, or nullptr when it is not one.
+    template <typename T>
+    [[nodiscard]] bool is() const {
+        return T::classof(kind);
+    }
+    template <typename T>
+    [[nodiscard]] const T* as() const {
+        return is<T>() ? static_cast<const T*>(this) : nullptr;
+    }
+    template <typename T>
+    [[nodiscard]] T* as() {
+        return is<T>() ? static_cast<T*>(this) : nullptr;
+    }
+
+protected:
+    explicit ASTNode(NodeKind kind) : kind(kind) {}
+};
+
+// Adds the kind tag and classof() test for a concrete node type.
+template <NodeKind K, typename Base>
+struct NodeWithKind : Base {
+    static constexpr NodeKind Kind = K;
+    static constexpr bool classof(NodeKind kind) { return kind == K; }
+protected:
+    NodeWithKind() : Base(K) {}
 };
 
 // Base Expression Node
-struct Exp : ASTNode {};
+struct Exp : ASTNode {
+    static constexpr bool classof(NodeKind kind) { return kind >= NodeKind::Var && kind <= NodeKind::Literal; }
+protected:
+    using ASTNode::ASTNode;
+};
 // Base Statement Node
-struct Statement : ASTNode {};
+struct Statement : ASTNode {
+    static constexpr bool classof(NodeKind kind) { return kind >= NodeKind::Return && kind <= NodeKind::Import; }
+protected:
+    using ASTNode::ASTNode;
+};
 
 // Program Node
-struct CompilationUnit : ASTNode {
-    std::vector<std::unique_ptr<ASTNode>> nodes;
-    explicit CompilationUnit(std::vector<std::unique_ptr<ASTNode>> n) : nodes(std::move(n)) {}
+struct CompilationUnit : NodeWithKind<NodeKind::CompilationUnit, ASTNode> {
+    Arena arena;
+    // One per parser thread; function definitions parsed in parallel live here.
+    std::vector<Arena> workerArenas;
+    std::span<ASTNode*> nodes;
 };
 
+struct Declare;
+
 // Function Node
-struct FunctionDef : ASTNode {
-    std::string name;
-    int allocationSize;
-    std::string returnType;
-    std::vector<std::unique_ptr<Statement>> statements;
-    FunctionDef(std::string n, int allocationSize, std::string rt, std::vector<std::unique_ptr<Statement>> s)
-        : name(std::move(n)), allocationSize(allocationSize), returnType(std::move(rt)), statements(std::move(s)) {}
+struct FunctionDef : NodeWithKind<NodeKind::FunctionDef, ASTNode> {
+    SymbolId name;
+    // Parameters in order, as declarations without initializers.
+    std::span<Declare*> parameters;
+    SymbolId returnType;
+    std::span<Statement*> statements;
+    FunctionDef(SymbolId n, std::span<Declare*> p, SymbolId rt, std::span<Statement*> s)
+        : name(n), parameters(p), returnType(rt), statements(s) {}
 };
 
 
 // Return Statement
-struct Return : Statement {
-    std::unique_ptr<Exp> expression;
-    explicit Return(std::unique_ptr<Exp> e) : expression(std::move(e)) {}
+struct Return : NodeWithKind<NodeKind::Return, Statement> {
+    Exp* expression;
+    explicit Return(Exp* e) : expression(e) {}
 };
 
 // Variable Declaration
-struct Declare : Statement {
-    std::string name;
-    std::string type;
-    std::optional<std::unique_ptr<Exp>> initializer;
-    Declare(std::string n, std::string type,std::optional<std::unique_ptr<Exp>> i = std::nullopt)
-        : name(std::move(n)), type(std::move(type)), initializer(std::move(i)) {}
+struct Declare : NodeWithKind<NodeKind::Declare, Statement> {
+    SymbolId name;
+    SymbolId type;
+    Exp* initializer; // nullptr without an initializer
+    Declare(SymbolId n, SymbolId type,Exp* i = nullptr)
+        : name(n), type(type), initializer(i) {}
 };
 
 // Expression Statement
-struct ExpStatement : Statement {
-    std::unique_ptr<Exp> expression;
-    explicit ExpStatement(std::unique_ptr<Exp> e) : expression(std::move(e)) {}
+struct ExpStatement : NodeWithKind<NodeKind::ExpStatement, Statement> {
+    Exp* expression;
+    explicit ExpStatement(Exp* e) : expression(e) {}
 };
 
 // Class Definition
-struct ClassDef : Statement {
-    std::string name;
-    std::vector<std::unique_ptr<Statement>> members;
-    ClassDef(std::string n, std::vector<std::unique_ptr<Statement>> m)
-        : name(std::move(n)), members(std::move(m)) {}
+struct ClassDef : NodeWithKind<NodeKind::ClassDef, Statement> {
+    SymbolId name;
+    std::span<Statement*> members;
+    ClassDef(SymbolId n, std::span<Statement*> m)
+        : name(n), members(m) {}
 };
 
 // Namespace Definition
-struct NamespaceDef : Statement {
-    std::string name;
-    std::vector<std::unique_ptr<Statement>> statements;
-    NamespaceDef(std::string n, std::vector<std::unique_ptr<Statement>> s)
-        : name(std::move(n)), statements(std::move(s)) {}
+struct NamespaceDef : NodeWithKind<NodeKind::NamespaceDef, Statement> {
+    SymbolId name;
+    std::span<Statement*> statements;
+    NamespaceDef(SymbolId n, std::span<Statement*> s)
+        : name(n), statements(s) {}
+};
+
+// Module Import: makes the exported functions of the named module's
+// interface file known to this unit.
+struct Import : NodeWithKind<NodeKind::Import, Statement> {
+    SymbolId module;
+    explicit Import(SymbolId m) : module(m) {}
 };
 
 // Variable Expression
-struct Var : Exp {
-    std::string name;
-    explicit Var(std::string n) : name(std::move(n)) {}
+struct Var : NodeWithKind<NodeKind::Var, Exp> {
+    SymbolId name;
+    explicit Var(SymbolId n) : name(n) {}
 };
 
-struct Assign : Exp {
-    std::string name;
-    std::unique_ptr<Exp> value;
-    Assign(std::string n, std::unique_ptr<Exp> v) : name(std::move(n)), value(std::move(v)) {}
+struct Assign : NodeWithKind<NodeKind::Assign, Exp> {
+    SymbolId name;
+    Exp* value;
+    Assign(SymbolId n, Exp* v) : name(n), value(v) {}
 };
 
 // Function Call
-struct FunctionCall : Exp {
-    std::string name;
-    std::vector<std::unique_ptr<Exp>> arguments;
-    FunctionCall(std::string n, std::vector<std::unique_ptr<Exp>> args)
-        : name(std::move(n)), arguments(std::move(args)) {}
+struct FunctionCall : NodeWithKind<NodeKind::FunctionCall, Exp> {
+    SymbolId name;
+    std::span<Exp*> arguments;
+    FunctionCall(SymbolId n, std::span<Exp*> args)
+        : name(n), arguments(args) {}
 };
 
 // Object Creation
-struct ObjectCreation : Exp {
-    std::string className;
-    std::vector<std::unique_ptr<Exp>> arguments;
-    ObjectCreation(std::string cn, std::vector<std::unique_ptr<Exp>> args)
-        : className(std::move(cn)), arguments(std::move(args)) {}
+struct ObjectCreation : NodeWithKind<NodeKind::ObjectCreation, Exp> {
+    SymbolId className;
+    std::span<Exp*> arguments;
+    ObjectCreation(SymbolId cn, std::span<Exp*> args)
+        : className(cn), arguments(args) {}
 };
 
 // Member Access
-struct MemberAccess : Exp {
-    std::unique_ptr<Exp> object;
-    std::string memberName;
-    MemberAccess(std::unique_ptr<Exp> obj, std::string mn)
-        : object(std::move(obj)), memberName(std::move(mn)) {}
+struct MemberAccess : NodeWithKind<NodeKind::MemberAccess, Exp> {
+    Exp* object;
+    SymbolId memberName;
+    MemberAccess(Exp* obj, SymbolId mn)
+        : object(obj), memberName(mn) {}
 };
 
 // Binary Operator Enum
 enum class BinaryOperator { Add, Sub, Mul, Div };
 
 // Binary Operation Expression
-struct BinOp : Exp {
+struct BinOp : NodeWithKind<NodeKind::BinOp, Exp> {
     BinaryOperator op;
-    std::unique_ptr<Exp> lhs;
-    std::unique_ptr<Exp> rhs;
-    BinOp(BinaryOperator o, std::unique_ptr<Exp> l, std::unique_ptr<Exp> r)
-        : op(o), lhs(std::move(l)), rhs(std::move(r)) {}
+    Exp* lhs;
+    Exp* rhs;
+    BinOp(BinaryOperator o, Exp* l, Exp* r)
+        : op(o), lhs(l), rhs(r) {}
 };
 
 // Unary Operator Enum
 enum class UnaryOperator { Neg };
 
 // Unary Operation Expression
-struct UnOp : Exp {
+struct UnOp : NodeWithKind<NodeKind::UnOp, Exp> {
     UnaryOperator op;
-    std::unique_ptr<Exp> operand;
-    UnOp(UnaryOperator o, std::unique_ptr<Exp> e) : op(o), operand(std::move(e)) {}
+    Exp* operand;
+    UnOp(UnaryOperator o, Exp* e) : op(o), operand(e) {}
 };
 
 // Literal Expression
-struct Literal : Exp {
+struct Literal : NodeWithKind<NodeKind::Literal, Exp> {
     int value;
     explicit Literal(int v) : value(v) {}
 };
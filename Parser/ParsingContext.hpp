@@ -5,47 +5,64 @@
 #ifndef PARSINGCONTEXT_HPP
 #define PARSINGCONTEXT_HPP
 
-#include <deque>
-
-#include "../Lexer/Lexer.cpp"
+#include <vector>
+#include "../Lexer/TokenBuffer.hpp"
+#include "ParserTypes.hpp"
 
+// Cursor over a pre-tokenized TokenBuffer. Lookahead is an index, so peeking
+// and advancing never copy a token.
 struct ParsingContext {
-  Lexer& lexer;
-  std::deque<Token> tokenQueue;
-  Token currentToken;
+  const TokenBuffer& tokens;
+  std::size_t index = 0;
+  // Tokens from end on read as TK_EOF, so one item can be parsed on its own.
+  std::size_t end;
+  // Arena of the unit being parsed; every node is allocated from it.
+  Arena* arena = nullptr;
+  // Shared stack for collecting child lists before they are copied into the
+  // arena; each list pops its own entries back off.
+  std::vector<ASTNode*> scratch;
 
-  explicit ParsingContext(Lexer& lexer) : lexer(lexer) {
-    currentToken= lexer.getNextToken();
-  }
+  explicit ParsingContext(const TokenBuffer& tokens) : tokens(tokens), end(tokens.size() - 1) {}
 
   void
   advance() {
-    if (tokenQueue.empty()) {
-      currentToken = lexer.getNextToken();
-    } else {
-      currentToken = tokenQueue.front();
-      tokenQueue.pop_front();
+    if (index < end) {
+      index++;
     }
   }
 
-  [[nodiscard]] Token
-  addNextTokenToDequeue() {
-    tokenQueue.emplace_back(lexer.getNextToken());
-    return tokenQueue.back();
+  [[nodiscard]] TokenKind
+  kind() const {
+    return index < end ? tokens.kinds[index] : TokenKind::TK_EOF;
+  }
+
+  // Kind of the token n positions ahead; peek(0) is the current token.
+  // Reading past the end yields TK_EOF.
+  [[nodiscard]] TokenKind
+  peek(std::size_t n) const {
+    return index + n < end ? tokens.kinds[index + n] : TokenKind::TK_EOF;
   }
-  [[nodiscard]] Token
-  getLastTokenFromQueue() {
-    return tokenQueue.back();
+
+  [[nodiscard]] SymbolId
+  symbol() const {
+    return tokens.symbols[index];
+  }
+
+  [[nodiscard]] std::string_view
+  text() const {
+    return index < end ? tokens.text(index) : std::string_view{};
   }
 
+  // Past end, the position just after the last token before it, so an
+  // error there does not depend on the text that follows.
   [[nodiscard]] int
   getCurrentLine() const {
-    return lexer.getCurrentLine();
+    return static_cast<int>(index < end || end == 0 ? tokens.lines[index] : tokens.lines[end - 1]);
   }
 
   [[nodiscard]] int
   getCurrentPosition() const {
-    return lexer.getCurrentPosition();
+    return index < end || end == 0 ? tokens.column(index) : tokens.endColumn(end - 1);
   }
 };
 
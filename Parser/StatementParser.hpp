@@ -15,93 +15,98 @@ public:
     explicit StatementParser(ParsingContext& context) : ParserBase(context), expressionParser(context) {
     }
 
-    std::unique_ptr<Statement> ParseStatement() {
-        if (context.currentToken.raw_val == "return") {
+    Statement* ParseStatement() {
+        if (context.kind() == TokenKind::TK_KW_RETURN) {
             context.advance();
             auto exp = expressionParser.ParseExpression();
-            Expect(";");
-            return std::make_unique<Return>(std::move(exp));
+            Expect(TokenKind::TK_SEMICOLON);
+            return Make<Return>(exp);
         }
-        if (context.currentToken.raw_val == "class") {
+        if (context.kind() == TokenKind::TK_KW_CLASS) {
             return ParseClassDef();
         }
-        if (context.currentToken.raw_val == "namespace") {
+        if (context.kind() == TokenKind::TK_KW_NAMESPACE) {
             return ParseNamespaceDef();
         }
-        if (context.currentToken.kind == TokenKind::TK_IDENTIFIER) {
-            std::string name = context.currentToken.raw_val;
+        if (context.kind() == TokenKind::TK_KW_IMPORT) {
+            context.advance();
+            SymbolId module = ExpectIdentifier();
+            Expect(TokenKind::TK_SEMICOLON);
+            return Make<Import>(module);
+        }
+        if (context.kind() == TokenKind::TK_IDENTIFIER) {
+            SymbolId name = context.symbol();
             context.advance();
 
-            if (context.currentToken.raw_val == ":") {
+            if (context.kind() == TokenKind::TK_COLON) {
                 context.advance();
-                if (context.currentToken.raw_val == "int") {
-                    std::string type = context.currentToken.raw_val;
+                if (context.kind() == TokenKind::TK_KW_INT) {
+                    SymbolId type = context.symbol();
                     context.advance();
 
-                    if (context.currentToken.raw_val == "=") {
+                    if (context.kind() == TokenKind::TK_EQUAL) {
                         context.advance();
                         auto initializer = expressionParser.ParseExpression();
-                        Expect(";");
-                        return std::make_unique<Declare>(std::move(name), std::move(type), std::move(initializer));
+                        Expect(TokenKind::TK_SEMICOLON);
+                        return Make<Declare>(name, type, initializer);
                     }
-                    Expect(";");
-                    return std::make_unique<Declare>(std::move(name), std::move(type));
+                    Expect(TokenKind::TK_SEMICOLON);
+                    return Make<Declare>(name, type);
                 }
                 throw std::runtime_error("Provided type not in system types in line: " + std::to_string(context.getCurrentLine()));
             }
-            if (context.currentToken.raw_val == "=") {
+            if (context.kind() == TokenKind::TK_EQUAL) {
                 context.advance();
                 auto exp = expressionParser.ParseExpression();
-                Expect(";");
-                return std::make_unique<ExpStatement>(std::make_unique<Assign>(std::move(name), std::move(exp)));
+                Expect(TokenKind::TK_SEMICOLON);
+                return Make<ExpStatement>(Make<Assign>(name, exp));
             }
             throw std::runtime_error("Unexpected token after identifier in line: " + std::to_string(context.getCurrentLine()));
         }
-        if (context.currentToken.raw_val == "int" ) {
+        if (context.kind() == TokenKind::TK_KW_INT) {
             return ParseVariableDeclaration();
         }
         throw std::runtime_error("Unexpected statement in line: " + std::to_string(context.getCurrentLine()) + " at position: " + std::to_string(context.getCurrentPosition()));
     }
 
 private:
-    std::unique_ptr<Statement> ParseVariableDeclaration() {
-        std::string type = context.currentToken.raw_val;
-        context.advance();
-        std::string name = context.currentToken.raw_val;
+    Statement* ParseVariableDeclaration() {
+        SymbolId type = context.symbol();
         context.advance();
-        std::optional<std::unique_ptr<Exp>> initializer = std::nullopt;
-        if (context.currentToken.raw_val == "=") {
+        SymbolId name = ExpectIdentifier();
+        Exp* initializer = nullptr;
+        if (context.kind() == TokenKind::TK_EQUAL) {
             context.advance();
             initializer = expressionParser.ParseExpression();
         }
-        Expect(";");
-        return std::make_unique<Declare>(std::move(name), std::move(type), std::move(initializer));
+        Expect(TokenKind::TK_SEMICOLON);
+        return Make<Declare>(name, type, initializer);
     }
 
-    std::unique_ptr<Statement> ParseClassDef() {
-        Expect("class");
-        std::string name = context.currentToken.raw_val;
-        context.advance();
-        Expect("{");
-        std::vector<std::unique_ptr<Statement>> members;
-        while (context.currentToken.raw_val != "}") {
-            members.push_back(ParseStatement());
+    Statement* ParseClassDef() {
+        Expect(TokenKind::TK_KW_CLASS);
+        SymbolId name = ExpectIdentifier();
+        Expect(TokenKind::TK_OPEN_BRACE);
+        const std::size_t mark = context.scratch.size();
+        while (context.kind() != TokenKind::TK_CLOSE_BRACE && context.kind() != TokenKind::TK_EOF) {
+            context.scratch.push_back(ParseStatement());
         }
-        Expect("}");
-        return std::make_unique<ClassDef>(std::move(name), std::move(members));
+        Expect(TokenKind::TK_CLOSE_BRACE);
+        auto members = context.arena->takeTail<Statement>(context.scratch, mark);
+        return Make<ClassDef>(name, members);
     }
 
-    std::unique_ptr<Statement> ParseNamespaceDef() {
-        Expect("namespace");
-        std::string name = context.currentToken.raw_val;
-        context.advance();
-        Expect("{");
-        std::vector<std::unique_ptr<Statement>> statements;
-        while (context.currentToken.raw_val != "}") {
-            statements.push_back(ParseStatement());
+    Statement* ParseNamespaceDef() {
+        Expect(TokenKind::TK_KW_NAMESPACE);
+        SymbolId name = ExpectIdentifier();
+        Expect(TokenKind::TK_OPEN_BRACE);
+        const std::size_t mark = context.scratch.size();
+        while (context.kind() != TokenKind::TK_CLOSE_BRACE && context.kind() != TokenKind::TK_EOF) {
+            context.scratch.push_back(ParseStatement());
         }
-        Expect("}");
-        return std::make_unique<NamespaceDef>(std::move(name), std::move(statements));
+        Expect(TokenKind::TK_CLOSE_BRACE);
+        auto statements = context.arena->takeTail<Statement>(context.scratch, mark);
+        return Make<NamespaceDef>(name, statements);
     }
 };
 
@@ -0,0 +1,371 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Just enough JSON for the language server protocol: parse a message, read
+// fields out of it and build replies. Numbers are kept as doubles.
+class Json {
+  public:
+  enum class Type { Null, Bool, Number, String, Array, Object };
+
+  Json() = default;
+  Json(std::nullptr_t) {}
+  Json(bool value) : type(Type::Bool), boolean(value) {}
+  Json(int value) : type(Type::Number), number(value) {}
+  Json(double value) : type(Type::Number), number(value) {}
+  Json(std::string value) : type(Type::String), string(std::move(value)) {}
+  Json(const char* value) : type(Type::String), string(value) {}
+
+  static Json
+  Array(std::vector<Json> items) {
+    Json json;
+    json.type = Type::Array;
+    json.items = std::move(items);
+    return json;
+  }
+
+  static Json
+  Object(std::vector<std::pair<std::string, Json>> members) {
+    Json json;
+    json.type = Type::Object;
+    json.members = std::move(members);
+    return json;
+  }
+
+  static Json
+  Parse(std::string_view text) {
+    Reader reader{text};
+    Json json = reader.Value();
+    reader.SkipSpace();
+    if (reader.position != text.size()) {
+      throw std::runtime_error("Trailing characters after JSON value");
+    }
+    return json;
+  }
+
+  // Member of an object, or null when missing or not an object.
+  const Json&
+  operator[](std::string_view key) const {
+    static const Json null;
+    for (const auto& [name, value] : members) {
+      if (name == key) {
+        return value;
+      }
+    }
+    return null;
+  }
+
+  [[nodiscard]] bool has(std::string_view key) const { return !(*this)[key].isNull(); }
+  [[nodiscard]] bool isNull() const { return type == Type::Null; }
+  [[nodiscard]] bool asBool() const { return type == Type::Bool && boolean; }
+  [[nodiscard]] int asInt() const { return static_cast<int>(number); }
+  [[nodiscard]] const std::string& asString() const { return string; }
+  [[nodiscard]] const std::vector<Json>& asArray() const { return items; }
+
+  [[nodiscard]] std::string
+  Dump() const {
+    std::string out;
+    Write(out);
+    return out;
+  }
+
+  private:
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<Json> items;
+  std::vector<std::pair<std::string, Json>> members;
+
+  void
+  Write(std::string& out) const {
+    switch (type) {
+      case Type::Null: out += "null"; break;
+      case Type::Bool: out += boolean ? "true" : "false"; break;
+      case Type::Number:
+        if (number == static_cast<double>(static_cast<std::int64_t>(number))) {
+          out += std::to_string(static_cast<std::int64_t>(number));
+        } else {
+          out += std::to_string(number);
+        }
+        break;
+      case Type::String: WriteString(out, string); break;
+      case Type::Array:
+        out += '[';
+        for (std::size_t i = 0; i < items.size(); ++i) {
+          if (i > 0) {
+            out += ',';
+          }
+          items[i].Write(out);
+        }
+        out += ']';
+        break;
+      case Type::Object:
+        out += '{';
+        for (std::size_t i = 0; i < members.size(); ++i) {
+          if (i > 0) {
+            out += ',';
+          }
+          WriteString(out, members[i].first);
+          out += ':';
+          members[i].second.Write(out);
+        }
+        out += '}';
+        break;
+    }
+  }
+
+  // Writes text as a JSON string. Bytes that are not part of well-formed
+  // UTF-8 become U+FFFD, so the output is valid UTF-8 whatever text holds.
+  static void
+  WriteString(std::string& out, std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+    out += '"';
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      const char ch = text[i];
+      if (static_cast<unsigned char>(ch) >= 0x80) {
+        const std::size_t length = Utf8Length(text, i);
+        if (length == 0) {
+          out += "\\ufffd";
+        } else {
+          out += text.substr(i, length);
+          i += length - 1;
+        }
+        continue;
+      }
+      switch (ch) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(ch) < 0x20) {
+            out += "\\u00";
+            out += hex[(ch >> 4) & 0xF];
+            out += hex[ch & 0xF];
+          } else {
+            out += ch;
+          }
+      }
+    }
+    out += '"';
+  }
+
+  // Length of the well-formed UTF-8 sequence starting at text[i], or 0 when
+  // there is none: a stray continuation byte, a truncated sequence, an
+  // overlong encoding, a surrogate or a code point past U+10FFFF.
+  static std::size_t
+  Utf8Length(std::string_view text, std::size_t i) {
+    const auto lead = static_cast<unsigned char>(text[i]);
+    const std::size_t length = lead < 0x80 ? 1 : lead < 0xC2 ? 0 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : lead < 0xF5 ? 4 : 0;
+    if (length == 0 || text.size() - i < length) {
+      return 0;
+    }
+    for (std::size_t k = 1; k < length; ++k) {
+      if ((static_cast<unsigned char>(text[i + k]) & 0xC0) != 0x80) {
+        return 0;
+      }
+    }
+    const auto second = length > 1 ? static_cast<unsigned char>(text[i + 1]) : 0;
+    if ((lead == 0xE0 && second < 0xA0) || (lead == 0xED && second >= 0xA0) || (lead == 0xF0 && second < 0x90) ||
+        (lead == 0xF4 && second >= 0x90)) {
+      return 0;
+    }
+    return length;
+  }
+
+  struct Reader {
+    std::string_view text;
+    std::size_t position = 0;
+
+    void
+    SkipSpace() {
+      while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+        position++;
+      }
+    }
+
+    char
+    Next() {
+      if (position >= text.size()) {
+        throw std::runtime_error("Unexpected end of JSON");
+      }
+      return text[position++];
+    }
+
+    void
+    ExpectWord(std::string_view word) {
+      if (text.substr(position, word.size()) != word) {
+        throw std::runtime_error("Invalid JSON literal");
+      }
+      position += word.size();
+    }
+
+    Json
+    Value() {
+      SkipSpace();
+      if (position >= text.size()) {
+        throw std::runtime_error("Unexpected end of JSON");
+      }
+      switch (text[position]) {
+        case '{': return ObjectValue();
+        case '[': return ArrayValue();
+        case '"': return {String()};
+        case 't': ExpectWord("true"); return {true};
+        case 'f': ExpectWord("false"); return {false};
+        case 'n': ExpectWord("null"); return {};
+        default: return NumberValue();
+      }
+    }
+
+    Json
+    ObjectValue() {
+      position++;
+      Json json = Object({});
+      SkipSpace();
+      if (position < text.size() && text[position] == '}') {
+        position++;
+        return json;
+      }
+      while (true) {
+        SkipSpace();
+        if (Next() != '"') {
+          throw std::runtime_error("Expected JSON object key");
+        }
+        position--;
+        std::string key = String();
+        SkipSpace();
+        if (Next() != ':') {
+          throw std::runtime_error("Expected ':' in JSON object");
+        }
+        json.members.emplace_back(std::move(key), Value());
+        SkipSpace();
+        const char separator = Next();
+        if (separator == '}') {
+          return json;
+        }
+        if (separator != ',') {
+          throw std::runtime_error("Expected ',' or '}' in JSON object");
+        }
+      }
+    }
+
+    Json
+    ArrayValue() {
+      position++;
+      Json json = Array({});
+      SkipSpace();
+      if (position < text.size() && text[position] == ']') {
+        position++;
+        return json;
+      }
+      while (true) {
+        json.items.push_back(Value());
+        SkipSpace();
+        const char separator = Next();
+        if (separator == ']') {
+          return json;
+        }
+        if (separator != ',') {
+          throw std::runtime_error("Expected ',' or ']' in JSON array");
+        }
+      }
+    }
+
+    Json
+    NumberValue() {
+      const std::size_t start = position;
+      while (position < text.size() && std::string_view("+-0123456789.eE").find(text[position]) != std::string_view::npos) {
+        position++;
+      }
+      if (start == position) {
+        throw std::runtime_error("Invalid JSON value");
+      }
+      return {std::stod(std::string(text.substr(start, position - start)))};
+    }
+
+    std::uint32_t
+    Hex4() {
+      std::uint32_t value = 0;
+      for (int i = 0; i < 4; ++i) {
+        const char ch = Next();
+        value <<= 4;
+        if (ch >= '0' && ch <= '9') {
+          value |= ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+          value |= ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+          value |= ch - 'A' + 10;
+        } else {
+          throw std::runtime_error("Invalid JSON unicode escape");
+        }
+      }
+      return value;
+    }
+
+    std::string
+    String() {
+      position++;
+      std::string out;
+      while (true) {
+        const char ch = Next();
+        if (ch == '"') {
+          return out;
+        }
+        if (ch != '\\') {
+          out += ch;
+          continue;
+        }
+        switch (const char escape = Next()) {
+          case 'n': out += '\n'; break;
+          case 'r': out += '\r'; break;
+          case 't': out += '\t'; break;
+          case 'b': out += '\b'; break;
+          case 'f': out += '\f'; break;
+          case 'u': {
+            std::uint32_t code = Hex4();
+            if (code >= 0xD800 && code < 0xDC00 && text.substr(position, 2) == "\\u") {
+              position += 2;
+              code = 0x10000 + ((code - 0xD800) << 10) + (Hex4() - 0xDC00);
+            }
+            AppendUtf8(out, code);
+            break;
+          }
+          default: out += escape; break;
+        }
+      }
+    }
+
+    static void
+    AppendUtf8(std::string& out, std::uint32_t code) {
+      if (code < 0x80) {
+        out += static_cast<char>(code);
+      } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+      } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+      } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+      }
+    }
+  };
+};
+
+#endif //JSON_HPP
@@ -0,0 +1,201 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+// Language server for Cej over stdin/stdout (JSON-RPC with Content-Length
+// framing). Open documents are kept in an IncrementalParser, so each edit
+// relexes and reparses only the top-level items it touches, and syntax errors
+// are published as diagnostics after every change.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "../Parser/IncrementalParser.hpp"
+#include "Json.hpp"
+
+class LanguageServer {
+  public:
+  LanguageServer(std::istream& in, std::ostream& out) : in(in), out(out) {}
+
+  // Serves requests until 'exit'. Returns the process exit code.
+  int
+  Run() {
+    std::string body;
+    while (ReadMessage(body)) {
+      Json message;
+      try {
+        message = Json::Parse(body);
+      } catch (const std::runtime_error& error) {
+        SendError(Json(), ParseError, error.what());
+        continue;
+      }
+      const std::string& method = message["method"].asString();
+      if (method == "exit") {
+        return shutdownRequested ? 0 : 1;
+      }
+      try {
+        Handle(method, message);
+      } catch (const std::exception& error) {
+        if (message.has("id")) {
+          SendError(message["id"], InternalError, error.what());
+        } else {
+          std::cerr << "Failed to handle " << method << ": " << error.what() << std::endl;
+        }
+      }
+    }
+    return 1;
+  }
+
+  private:
+  static constexpr int ParseError = -32700;
+  static constexpr int MethodNotFound = -32601;
+  static constexpr int InternalError = -32603;
+  // TextDocumentSyncKind.Incremental
+  static constexpr int IncrementalSync = 2;
+
+  std::istream& in;
+  std::ostream& out;
+  std::unordered_map<std::string, IncrementalParser> documents;
+  bool shutdownRequested = false;
+
+  bool
+  ReadMessage(std::string& body) {
+    std::size_t length = 0;
+    std::string header;
+    while (std::getline(in, header)) {
+      if (!header.empty() && header.back() == '\r') {
+        header.pop_back();
+      }
+      if (header.empty()) {
+        break;
+      }
+      constexpr std::string_view contentLength = "Content-Length:";
+      if (header.starts_with(contentLength)) {
+        length = std::stoul(header.substr(contentLength.size()));
+      }
+    }
+    if (!in || length == 0) {
+      return false;
+    }
+    body.resize(length);
+    return static_cast<bool>(in.read(body.data(), static_cast<std::streamsize>(length)));
+  }
+
+  void
+  Send(const Json& message) {
+    const std::string body = message.Dump();
+    out << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    out.flush();
+  }
+
+  void
+  Reply(const Json& id, Json result) {
+    Send(Json::Object({{"jsonrpc", "2.0"}, {"id", id}, {"result", std::move(result)}}));
+  }
+
+  void
+  SendError(const Json& id, int code, const std::string& text) {
+    Send(Json::Object({{"jsonrpc", "2.0"}, {"id", id},
+      {"error", Json::Object({{"code", code}, {"message", text}})}}));
+  }
+
+  void
+  Handle(const std::string& method, const Json& message) {
+    const Json& params = message["params"];
+    if (method == "initialize") {
+      Reply(message["id"], Initialize(params));
+    } else if (method == "shutdown") {
+      shutdownRequested = true;
+      Reply(message["id"], Json());
+    } else if (method == "textDocument/didOpen") {
+      const Json& document = params["textDocument"];
+      const std::string& uri = document["uri"].asString();
+      documents.insert_or_assign(uri, IncrementalParser(uri, document["text"].asString()));
+      PublishDiagnostics(uri);
+    } else if (method == "textDocument/didChange") {
+      DidChange(params);
+    } else if (method == "textDocument/didClose") {
+      const std::string& uri = params["textDocument"]["uri"].asString();
+      documents.erase(uri);
+      Send(Json::Object({{"jsonrpc", "2.0"}, {"method", "textDocument/publishDiagnostics"},
+        {"params", Json::Object({{"uri", uri}, {"diagnostics", Json::Array({})}})}}));
+    } else if (message.has("id")) {
+      SendError(message["id"], MethodNotFound, "Unsupported method " + method);
+    }
+    // Other notifications ('initialized', '$/...') need no answer.
+  }
+
+  static Json
+  Initialize(const Json& params) {
+    std::vector<std::pair<std::string, Json>> capabilities = {
+      {"textDocumentSync", Json::Object({{"openClose", true}, {"change", IncrementalSync}})},
+    };
+    // Columns are byte offsets. Clients that can count in UTF-8 are told so;
+    // for the others this only matters on lines with non-ASCII text.
+    for (const Json& encoding : params["capabilities"]["general"]["positionEncodings"].asArray()) {
+      if (encoding.asString() == "utf-8") {
+        capabilities.emplace_back("positionEncoding", "utf-8");
+      }
+    }
+    return Json::Object({{"capabilities", Json::Object(std::move(capabilities))},
+      {"serverInfo", Json::Object({{"name", "cej-language-server"}})}});
+  }
+
+  void
+  DidChange(const Json& params) {
+    const std::string& uri = params["textDocument"]["uri"].asString();
+    const auto found = documents.find(uri);
+    if (found == documents.end()) {
+      return;
+    }
+    IncrementalParser& document = found->second;
+    const auto start = std::chrono::steady_clock::now();
+    for (const Json& change : params["contentChanges"].asArray()) {
+      if (!change.has("range")) {
+        document.Replace(change["text"].asString());
+        continue;
+      }
+      const Json& range = change["range"];
+      document.Edit(range["start"]["line"].asInt(), range["start"]["character"].asInt(),
+                    range["end"]["line"].asInt(), range["end"]["character"].asInt(), change["text"].asString());
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << std::format("Updated {} in {:.0f} us ({} of {} chunks reparsed)\n",
+      uri, elapsed.count(), document.getLastRebuiltChunks(), document.getChunkCount());
+    PublishDiagnostics(uri);
+  }
+
+  void
+  PublishDiagnostics(const std::string& uri) {
+    std::vector<Json> diagnostics;
+    for (const IncrementalParser::Diagnostic& diagnostic : documents.at(uri).Diagnostics()) {
+      std::string text = diagnostic.message;
+      while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.pop_back();
+      }
+      const int line = std::max(diagnostic.line - 1, 0);
+      diagnostics.push_back(Json::Object({
+        {"range", Json::Object({
+          {"start", Json::Object({{"line", line}, {"character", diagnostic.column}})},
+          {"end", Json::Object({{"line", line}, {"character", diagnostic.column + 1}})},
+        })},
+        {"severity", 1},
+        {"source", "cej"},
+        {"message", text},
+      }));
+    }
+    Send(Json::Object({{"jsonrpc", "2.0"}, {"method", "textDocument/publishDiagnostics"},
+      {"params", Json::Object({{"uri", uri}, {"diagnostics", Json::Array(std::move(diagnostics))}})}}));
+  }
+};
+
+int main() {
+  std::ios::sync_with_stdio(false);
+  // The lexer and parser report progress on std::cout; stdout carries the
+  // protocol, so that chatter goes to stderr instead.
+  std::ostream protocol(std::cout.rdbuf());
+  std::cout.rdbuf(std::cerr.rdbuf());
+  LanguageServer server(std::cin, protocol);
+  return server.Run();
+}
@@ -0,0 +1,73 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include "../Generator/Assembler.hpp"
+
+// Expected words are what the system assembler produces for the same line.
+static std::vector<std::uint32_t>
+Words(const std::vector<std::string>& text) {
+  std::vector<Peephole::Line> lines;
+  for (const std::string& line : text) {
+    lines.push_back(Peephole::Line::Parse(line));
+  }
+  const ObjectCode code = Assembler::Assemble(lines);
+  std::vector<std::uint32_t> words;
+  for (std::size_t i = 0; i + 4 <= code.text.size(); i += 4) {
+    words.push_back(code.text[i] | code.text[i + 1] << 8 | code.text[i + 2] << 16 |
+                    static_cast<std::uint32_t>(code.text[i + 3]) << 24);
+  }
+  return words;
+}
+
+static std::uint32_t
+Word(const std::string& line) {
+  return Words({line}).at(0);
+}
+
+TEST(AssemblerTest, EncodesFrameInstructions) {
+  EXPECT_EQ(Word("\tstp x29, x30, [sp, #-16]!"), 0xA9BF7BFDu);
+  EXPECT_EQ(Word("\tldp x29, x30, [sp], #16"), 0xA8C17BFDu);
+  EXPECT_EQ(Word("\tmov x29, sp"), 0x910003FDu);
+  EXPECT_EQ(Word("\tsub sp, sp, x16"), 0xCB3063FFu);
+  EXPECT_EQ(Word("\tstp x19, x20, [x29, #-16]"), 0xA93F53B3u);
+  EXPECT_EQ(Word("\tldr x9, [x29, #-8]"), 0xF85F83A9u);
+  EXPECT_EQ(Word("\tldr x9, [sp, #32760]"), 0xF97FFFE9u);
+  EXPECT_EQ(Word("\tstr x9, [sp, #-16]!"), 0xF81F0FE9u);
+}
+
+TEST(AssemblerTest, EncodesArithmetic) {
+  EXPECT_EQ(Word("\tadd x9, x10, x11, lsl #3"), 0x8B0B0D49u);
+  EXPECT_EQ(Word("\tsub x9, x29, #4095"), 0xD13FFFA9u);
+  EXPECT_EQ(Word("\tmadd x9, x10, x11, x12"), 0x9B0B3149u);
+  EXPECT_EQ(Word("\tsmulh x1, x2, x3"), 0x9B437C41u);
+  EXPECT_EQ(Word("\tsdiv x1, x2, x3"), 0x9AC30C41u);
+  EXPECT_EQ(Word("\tlsl x9, x10, #63"), 0xD3410149u);
+  EXPECT_EQ(Word("\tasr x9, x10, #1"), 0x9341FD49u);
+  EXPECT_EQ(Word("\tmov x9, #-65536"), 0x929FFFE9u);
+  EXPECT_EQ(Word("\tmovk x9, #1, lsl #32"), 0xF2C00029u);
+}
+
+TEST(AssemblerTest, ResolvesLocalLabelsAndRelocatesCalls) {
+  const std::vector<std::string> text = {"\t.globl f", "f:", "\tb .Lf_1", "\tbl g", ".Lf_1:", "\tb g"};
+  EXPECT_EQ(Words(text), (std::vector<std::uint32_t>{0x14000002u, 0x94000000u, 0x14000000u}));
+
+  std::vector<Peephole::Line> lines;
+  for (const std::string& line : text) {
+    lines.push_back(Peephole::Line::Parse(line));
+  }
+  const ObjectCode code = Assembler::Assemble(lines);
+  ASSERT_EQ(code.relocations.size(), 2u);
+  EXPECT_EQ(code.relocations[0].offset, 4u);
+  EXPECT_EQ(code.relocations[0].type, 283u);
+  EXPECT_EQ(code.relocations[1].type, 282u);
+  EXPECT_EQ(code.symbols[code.relocations[0].symbol].name, "g");
+  EXPECT_FALSE(code.symbols[code.relocations[0].symbol].defined);
+  EXPECT_TRUE(code.symbols[0].global);
+  EXPECT_EQ(code.symbols[0].size, 12u);
+}
+
+TEST(AssemblerTest, RejectsUnknownInstructions) {
+  EXPECT_THROW(Word("\tcbz x0, .Lf_1"), std::runtime_error);
+  EXPECT_THROW(Word("\tadd x0, x1, #4096"), std::runtime_error);
+}
@@ -0,0 +1,40 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include "../Generator/Generator.cpp"
+#include "../IR/Interpreter.hpp"
+
+static IRModule
+Build(std::string_view source, std::string_view level) {
+  CompilerOptions options;
+  options.Parse(level);
+  Lexer lexer(source, "test");
+  Parser parser(lexer);
+  return Generator::BuildIR(*parser.parseUnit(), options);
+}
+
+// A divisor that only becomes zero through propagation or inlining is left
+// for run time, so every level accepts what -O0 accepts.
+TEST(ConstantFoldingTest, KeepsDivisionsByAFoldedZero) {
+  const std::string_view inlined = "z :: (a: int) int {\n  return 10 / a;\n}\n"
+                                   "main :: () int {\n  q:int = 0;\n  return z(q) * 0 + 1;\n}\n";
+  const std::string_view propagated = "main :: () int {\n  x:int = 0;\n  return 5 / x;\n}\n";
+  for (const std::string_view level : {"-O0", "-O1", "-O2", "-Os"}) {
+    EXPECT_NO_THROW(Build(inlined, level)) << level;
+    EXPECT_NO_THROW(Build(propagated, level)) << level;
+  }
+  const IRModule module = Build(inlined, "-O2");
+  EXPECT_EQ(*Interpreter(module, Interpreter::Limits{}).Call(Interner::intern("main")), 1);
+}
+
+TEST(ConstantFoldingTest, RejectsALiteralZeroDivisor) {
+  for (const std::string_view level : {"-O0", "-O2"}) {
+    try {
+      Build("main :: () int {\n  return 5 / 0;\n}\n", level);
+      ADD_FAILURE() << "compiled at " << level;
+    } catch (const std::runtime_error& error) {
+      EXPECT_STREQ(error.what(), "Division by zero in function 'main'");
+    }
+  }
+}
@@ -0,0 +1,99 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include <random>
+#include <tuple>
+#include "../Parser/IncrementalParser.hpp"
+
+using Diagnostics = std::vector<std::tuple<int, int, std::string>>;
+
+static Diagnostics
+DiagnosticsOf(const IncrementalParser& document) {
+  Diagnostics diagnostics;
+  for (const IncrementalParser::Diagnostic& diagnostic : document.Diagnostics()) {
+    diagnostics.emplace_back(diagnostic.line, diagnostic.column, diagnostic.message);
+  }
+  return diagnostics;
+}
+
+static std::vector<NodeKind>
+KindsOf(const IncrementalParser& document) {
+  std::vector<NodeKind> kinds;
+  for (const ASTNode* node : document.Nodes()) {
+    kinds.push_back(node->kind);
+  }
+  return kinds;
+}
+
+// An edited document must read the same as its text parsed from scratch.
+static void
+ExpectSameAsFresh(const IncrementalParser& document) {
+  const IncrementalParser fresh("test", document.Text());
+  EXPECT_EQ(KindsOf(document), KindsOf(fresh)) << document.Text();
+  EXPECT_EQ(DiagnosticsOf(document), DiagnosticsOf(fresh)) << document.Text();
+}
+
+TEST(IncrementalParserTest, LexerErrorDropsTheRestOfTheDocument) {
+  IncrementalParser document("test", "a :: () int {\n  return 1;\n}\nb :: () int {\n  return 2;\n}\nx:int = 3;\n");
+  ASSERT_EQ(document.Nodes().size(), 3u);
+  document.Edit(1, 2, 1, 2, "@");
+  EXPECT_TRUE(document.Nodes().empty());
+  ASSERT_EQ(document.Diagnostics().size(), 1u);
+  EXPECT_EQ(document.Diagnostics()[0].line, 2);
+  EXPECT_EQ(document.Diagnostics()[0].column, 2);
+  ExpectSameAsFresh(document);
+
+  document.Edit(1, 2, 1, 3, "");
+  EXPECT_EQ(document.Nodes().size(), 3u);
+  EXPECT_TRUE(document.Diagnostics().empty());
+}
+
+TEST(IncrementalParserTest, LexerErrorKeepsItemsBeforeTheOneItEnds) {
+  IncrementalParser document("test", "x:int = 1;\ny:int = 2;\nf :: () int {\n  return 3;\n}\n");
+  document.Edit(3, 9, 3, 9, "#");
+  EXPECT_EQ(document.Nodes().size(), 2u);
+  ExpectSameAsFresh(document);
+}
+
+TEST(IncrementalParserTest, ErrorAtTheEndOfAnItemIsReportedAfterIt) {
+  IncrementalParser document("test", "k :: ();\n p:int = 1;\n");
+  document.Edit(0, 0, 0, 0, " ");
+  ASSERT_EQ(document.Diagnostics().size(), 1u);
+  EXPECT_EQ(document.Diagnostics()[0].line, 1);
+  EXPECT_EQ(document.Diagnostics()[0].column, 9);
+  ExpectSameAsFresh(document);
+}
+
+TEST(IncrementalParserTest, RandomEditsMatchAFreshParse) {
+  const std::vector<std::string> fragments = {
+    "main :: () int {\n  x:int = 3;\n  return x;\n}\n", "f :: (a: int) int {\n  return a * 2;\n}\n",
+    "x:int = 1;\n", "y = x + 2;\n", "class C { v:int = 1; }\n", "k :: ();", "\n", " ", "{", "}", ";", "(",
+    ")", "@", "\xC3\xA9", "return 1;", "12", " 34", "foo(", "1 +", "::", "int", "x", "="};
+  std::mt19937 random(1);
+  const auto pick = [&](std::size_t count) { return static_cast<std::size_t>(random() % count); };
+  for (int round = 0; round < 20; ++round) {
+    std::string text;
+    for (std::size_t i = pick(10); i > 0; --i) {
+      text += fragments[pick(fragments.size())];
+    }
+    IncrementalParser document("test", text);
+    for (int edit = 0; edit < 40; ++edit) {
+      const std::string current = document.Text();
+      const std::size_t start = pick(current.size() + 1);
+      const std::size_t end = pick(3) == 0 ? std::min(current.size(), start + pick(20)) : start;
+      const auto position = [&](std::size_t offset) {
+        const std::size_t lineStart = offset == 0 ? 0 : current.rfind('\n', offset - 1) + 1;
+        const auto line = static_cast<int>(std::count(current.begin(), current.begin() + static_cast<std::ptrdiff_t>(offset), '\n'));
+        return std::pair{line, static_cast<int>(offset - lineStart)};
+      };
+      const auto [startLine, startColumn] = position(start);
+      const auto [endLine, endColumn] = position(end);
+      document.Edit(startLine, startColumn, endLine, endColumn, pick(4) == 0 ? "" : fragments[pick(fragments.size())]);
+      ExpectSameAsFresh(document);
+      if (HasFailure()) {
+        return;
+      }
+    }
+  }
+}
@@ -0,0 +1,36 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include "../IR/Interpreter.hpp"
+#include "../IR/Lowering.hpp"
+#include "../IR/Verifier.hpp"
+#include "../Parser/Parser.cpp"
+
+static IRModule
+Lower(std::string_view source) {
+  Lexer lexer(source, "test");
+  Parser parser(lexer);
+  const auto unit = parser.parseUnit();
+  return Lowering::Lower(*unit);
+}
+
+TEST(LoweringTest, LowersFunctions) {
+  IRModule module = Lower("twice :: (a: int) int {\n  return a * 2;\n}\nmain :: () int {\n  x:int = 3;\n  return twice(x);\n}\n");
+  Verifier::Verify(module, "after lowering");
+  EXPECT_EQ(*Interpreter(module, Interpreter::Limits{}).Call(Interner::intern("main")), 6);
+}
+
+TEST(LoweringTest, RejectsStatementsAtTopLevel) {
+  for (const std::string_view source : {"x:int = 3;\nmain :: () int { return 1; }\n",
+                                        "main :: () int { return 1; }\nx:int = 3;\n",
+                                        "main :: () int { return 1; }\nreturn 2;\n",
+                                        "main :: () int { x:int = 1; return x; }\nx = 2;\n"}) {
+    try {
+      Lower(source);
+      ADD_FAILURE() << "lowered " << source;
+    } catch (const std::runtime_error& error) {
+      EXPECT_STREQ(error.what(), "Only functions, classes, namespaces and imports may appear at the top level");
+    }
+  }
+}
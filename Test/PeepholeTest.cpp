@@ -0,0 +1,113 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include <map>
+#include "../Generator/Peephole.hpp"
+
+// The lines text becomes after the peephole pass, and the hits of each rule.
+struct Rewritten {
+  std::vector<std::string> text;
+  std::map<std::string, std::uint64_t, std::less<>> hits;
+};
+
+static Rewritten
+Rewrite(const std::vector<std::string>& text) {
+  std::vector<Peephole::Line> lines;
+  for (const std::string& line : text) {
+    lines.push_back(Peephole::Line::Parse(line));
+  }
+  Peephole peephole;
+  peephole.Run(lines);
+  Rewritten rewritten;
+  for (const Peephole::Line& line : lines) {
+    rewritten.text.push_back(line.text);
+  }
+  for (const Peephole::Rule& rule : peephole.rules) {
+    if (rule.hits != 0) {
+      rewritten.hits.emplace(rule.name, rule.hits);
+    }
+  }
+  return rewritten;
+}
+
+// Expects rule to rewrite before into after, and nothing else to fire.
+static void
+ExpectRewrite(std::string_view rule, const std::vector<std::string>& before, const std::vector<std::string>& after) {
+  const Rewritten rewritten = Rewrite(before);
+  EXPECT_EQ(rewritten.text, after);
+  EXPECT_EQ(rewritten.hits, (std::map<std::string, std::uint64_t, std::less<>>{{std::string(rule), 1}}));
+}
+
+static void
+ExpectUnchanged(const std::vector<std::string>& text) {
+  const Rewritten rewritten = Rewrite(text);
+  EXPECT_EQ(rewritten.text, text);
+  EXPECT_TRUE(rewritten.hits.empty());
+}
+
+TEST(PeepholeTest, RemovesSelfMoves) {
+  ExpectRewrite("self-move", {"\tmov x9, x9", "\tret"}, {"\tret"});
+  ExpectUnchanged({"\tmov x1, x10", "\tret"});
+}
+
+TEST(PeepholeTest, TurnsPushPopIntoAMove) {
+  ExpectRewrite("push-pop", {"\tstr x9, [sp, #-16]!", "\tldr x10, [sp], #16"}, {"\tmov x10, x9"});
+  // Popped by another amount, sp does not come back to where it was.
+  ExpectUnchanged({"\tstr x9, [sp, #-16]!", "\tldr x10, [sp], #8"});
+  ExpectUnchanged({"\tstr x9, [sp, #-16]!", "\tldr x10, [sp]"});
+}
+
+TEST(PeepholeTest, ForwardsAStoreToTheLoadAfterIt) {
+  ExpectRewrite("store-to-load", {"\tstr x9, [x29, #-8]", "\tldr x10, [x29, #-8]"},
+                {"\tstr x9, [x29, #-8]", "\tmov x10, x9"});
+  // Writeback moves the base between the two, so they are different places.
+  ExpectUnchanged({"\tstr x9, [x29, #-8]!", "\tldr x10, [x29, #-8]!"});
+  ExpectUnchanged({"\tstr x9, [x29, #-8]", "\tldr x10, [x29], #-8"});
+  ExpectUnchanged({"\tstr x9, [x29, #-8]", "\tldr x10, [x29, #-16]"});
+}
+
+TEST(PeepholeTest, DropsAMoveTheNextInstructionOverwrites) {
+  // x10 is a different register from x1.
+  ExpectRewrite("dead-move", {"\tmov x1, #3", "\tadd x1, x10, x2"}, {"\tadd x1, x10, x2"});
+  ExpectRewrite("dead-move", {"\tmov x1, x2", "\tldr x1, [x29, #-8]"}, {"\tldr x1, [x29, #-8]"});
+  ExpectUnchanged({"\tmov x1, #3", "\tadd x1, x2, x1"});
+  ExpectUnchanged({"\tmov x1, #3", "\tldr x1, [x1, #8]"});
+  ExpectUnchanged({"\tmov x1, #3", "\tmadd x1, x2, x3, x1"});
+  // A load with writeback also writes its base, and str writes no register.
+  ExpectUnchanged({"\tmov x1, #3", "\tldr x1, [sp], #16"});
+  ExpectUnchanged({"\tmov x1, #3", "\tstr x1, [x29, #-8]"});
+}
+
+TEST(PeepholeTest, FusesMultiplyAndAdd) {
+  ExpectRewrite("multiply-add", {"\tmul x9, x10, x11", "\tadd x9, x9, x12"}, {"\tmadd x9, x10, x11, x12"});
+  ExpectRewrite("multiply-add", {"\tmul x9, x10, x11", "\tadd x9, x12, x9"}, {"\tmadd x9, x10, x11, x12"});
+  // The product is also the addend.
+  ExpectUnchanged({"\tmul x9, x10, x11", "\tadd x9, x9, x9"});
+  // The product is still needed in x9.
+  ExpectUnchanged({"\tmul x9, x10, x11", "\tadd x12, x9, x13"});
+  ExpectUnchanged({"\tmul x9, x10, x11", "\tadd x9, x9, #4"});
+}
+
+TEST(PeepholeTest, FusesMultiplyAndSubtract) {
+  ExpectRewrite("multiply-subtract", {"\tmul x9, x10, x11", "\tsub x9, x12, x9"}, {"\tmsub x9, x10, x11, x12"});
+  // Product minus x12 is not x12 minus product.
+  ExpectUnchanged({"\tmul x9, x10, x11", "\tsub x9, x9, x12"});
+  ExpectUnchanged({"\tmul x9, x10, x11", "\tsub x9, x9, x9"});
+}
+
+TEST(PeepholeTest, FoldsAShiftIntoAnAdd) {
+  ExpectRewrite("shift-add", {"\tlsl x9, x10, #3", "\tadd x9, x9, x11"}, {"\tadd x9, x11, x10, lsl #3"});
+  ExpectRewrite("shift-add", {"\tlsl x9, x10, #3", "\tadd x9, x11, x9"}, {"\tadd x9, x11, x10, lsl #3"});
+  // By a register, or added to itself or a constant.
+  ExpectUnchanged({"\tlsl x9, x10, x12", "\tadd x9, x9, x11"});
+  ExpectUnchanged({"\tlsl x9, x10, #3", "\tadd x9, x9, x9"});
+  ExpectUnchanged({"\tlsl x9, x10, #3", "\tadd x9, x9, #8"});
+}
+
+TEST(PeepholeTest, LooksBackAfterARewriteButNotAcrossLabels) {
+  // Removing the self-move makes the dead move next to the add.
+  const Rewritten rewritten = Rewrite({"\tmov x1, #3", "\tmov x2, x2", "\tadd x1, x10, x2"});
+  EXPECT_EQ(rewritten.text, (std::vector<std::string>{"\tadd x1, x10, x2"}));
+  ExpectUnchanged({"\tmul x9, x10, x11", ".Lf_1:", "\tadd x9, x9, x12"});
+}
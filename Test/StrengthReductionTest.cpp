@@ -0,0 +1,133 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include "../IR/Interpreter.hpp"
+#include "../Optimizer/ConstantFolding.hpp"
+#include "../Optimizer/StrengthReduction.hpp"
+
+// main computes "input() op constant" after strength reduction; input's
+// return value is patched for each x, so the reduced code is built once per
+// constant and run by the interpreter.
+class Reduced {
+  public:
+  Reduced(Opcode op, std::int64_t constant) {
+    const SymbolId input = Interner::intern("input");
+    main = Interner::intern("main");
+    IRFunction inputFunction{.name = input};
+    inputFunction.NewBlock();
+    inputFunction.blocks[0].instructions = {{.op = Opcode::Ret, .operands = {Operand::Imm(0)}}};
+    IRFunction mainFunction{.name = main};
+    mainFunction.NewBlock();
+    const VReg x = mainFunction.NewRegister(IRType::I64);
+    const VReg result = mainFunction.NewRegister(IRType::I64);
+    mainFunction.blocks[0].instructions = {
+        {.op = Opcode::Call, .result = x, .callee = input},
+        {.op = op, .result = result, .operands = {Operand::Reg(x), Operand::Imm(constant)}},
+        {.op = Opcode::Ret, .operands = {Operand::Reg(result)}},
+    };
+    module.functions = {std::move(inputFunction), std::move(mainFunction)};
+    StrengthReduction().Run(module);
+    Verifier::Verify(module, "after strength reduction");
+  }
+
+  std::int64_t
+  operator()(std::int64_t x) {
+    module.functions[0].blocks[0].instructions[0].operands[0] = Operand::Imm(x);
+    return *Interpreter(module, Interpreter::Limits{}).Call(main);
+  }
+
+  [[nodiscard]] bool
+  Contains(Opcode op) const {
+    return std::ranges::any_of(module.functions[1].blocks[0].instructions,
+                               [&](const Instruction& instruction) { return instruction.op == op; });
+  }
+
+  private:
+  IRModule module;
+  SymbolId main;
+};
+
+constexpr std::int64_t Min = std::numeric_limits<std::int64_t>::min();
+constexpr std::int64_t Max = std::numeric_limits<std::int64_t>::max();
+
+TEST(StrengthReductionTest, DivisionExhaustiveSmallRange) {
+  for (std::int64_t d = -130; d <= 130; ++d) {
+    if (d == 0) {
+      continue;
+    }
+    Reduced divide(Opcode::SDiv, d);
+    EXPECT_EQ(d == 1, divide.Contains(Opcode::SDiv)) << "d = " << d;
+    for (std::int64_t x = -1100; x <= 1100; ++x) {
+      ASSERT_EQ(x / d, divide(x)) << x << " / " << d;
+    }
+    for (const std::int64_t x : {Min, Min + 1, Max - 1, Max}) {
+      ASSERT_EQ(*ConstantFolding::Evaluate(Opcode::SDiv, x, d), divide(x)) << x << " / " << d;
+    }
+  }
+}
+
+TEST(StrengthReductionTest, DivisionRandomFullRange) {
+  std::mt19937_64 random(20261017);
+  std::vector<std::int64_t> divisors = {Min, Min + 1, Max, Max - 1, 3, -3, 7, -7, 641, 1000000007};
+  for (int shift = 1; shift < 63; ++shift) {
+    divisors.push_back(std::int64_t{1} << shift);
+    divisors.push_back(-(std::int64_t{1} << shift));
+  }
+  for (int i = 0; i < 500; ++i) {
+    // Random divisors of every magnitude, not only huge ones.
+    divisors.push_back(static_cast<std::int64_t>(random()) >> (random() % 63));
+  }
+  for (const std::int64_t d : divisors) {
+    if (d == 0) {
+      continue;
+    }
+    Reduced divide(Opcode::SDiv, d);
+    for (int i = 0; i < 1000; ++i) {
+      const auto x = static_cast<std::int64_t>(random()) >> (random() % 64);
+      ASSERT_EQ(*ConstantFolding::Evaluate(Opcode::SDiv, x, d), divide(x)) << x << " / " << d;
+    }
+    for (const std::int64_t x : {Min, Min + 1, std::int64_t{-1}, std::int64_t{0}, std::int64_t{1}, Max}) {
+      ASSERT_EQ(*ConstantFolding::Evaluate(Opcode::SDiv, x, d), divide(x)) << x << " / " << d;
+    }
+  }
+}
+
+TEST(StrengthReductionTest, MultiplicationExhaustiveSmallRange) {
+  for (std::int64_t c = -70; c <= 70; ++c) {
+    Reduced multiply(Opcode::Mul, c);
+    for (std::int64_t x = -1100; x <= 1100; ++x) {
+      ASSERT_EQ(x * c, multiply(x)) << x << " * " << c;
+    }
+  }
+  EXPECT_FALSE(Reduced(Opcode::Mul, 8).Contains(Opcode::Mul));
+  EXPECT_FALSE(Reduced(Opcode::Mul, 9).Contains(Opcode::Mul));
+  EXPECT_FALSE(Reduced(Opcode::Mul, 15).Contains(Opcode::Mul));
+  EXPECT_TRUE(Reduced(Opcode::Mul, 11).Contains(Opcode::Mul));
+}
+
+TEST(StrengthReductionTest, MultiplicationRandomFullRange) {
+  std::mt19937_64 random(20261017);
+  for (int shift = 1; shift < 63; ++shift) {
+    for (const std::int64_t offset : {-1, 0, 1}) {
+      const std::int64_t c = static_cast<std::int64_t>((std::uint64_t{1} << shift) + offset);
+      Reduced multiply(Opcode::Mul, c);
+      for (int i = 0; i < 200; ++i) {
+        const auto x = static_cast<std::int64_t>(random());
+        ASSERT_EQ(*ConstantFolding::Evaluate(Opcode::Mul, x, c), multiply(x)) << x << " * " << c;
+      }
+    }
+  }
+}
+
+TEST(StrengthReductionTest, MultiplyHighMatchesWideProduct) {
+  std::mt19937_64 random(20261017);
+  for (int i = 0; i < 100000; ++i) {
+    const auto a = static_cast<std::int64_t>(random());
+    const auto b = static_cast<std::int64_t>(random()) >> (random() % 64);
+    __extension__ using Wide = __int128;
+    ASSERT_EQ(static_cast<std::int64_t>((static_cast<Wide>(a) * b) >> 64), MultiplyHigh(a, b)) << a << " * " << b;
+  }
+}
@@ -0,0 +1,167 @@
+//
+// Created by Elijah Crain on 10/17/26.
+//
+#include <gtest/gtest.h>
+#include <sstream>
+#include "../Generator/Generator.cpp"
+#include "../Parser/Parser.cpp"
+
+// The lines of function in the x86-64 assembly for source at -O1, without
+// their indentation. -O1 keeps calls, which inlining or evaluating them
+// at compile time would remove.
+static std::vector<std::string>
+Function(std::string_view source, std::string_view function) {
+  CompilerOptions options;
+  options.Parse("--target=x86_64");
+  options.Parse("-O1");
+  Lexer lexer(source, "test");
+  Parser parser(lexer);
+  const auto unit = parser.parseUnit();
+  std::istringstream assembly(Generator::GenerateAssembly(*unit, options));
+  std::vector<std::string> lines;
+  bool inside = false;
+  for (std::string line; std::getline(assembly, line);) {
+    line.erase(0, line.find_first_not_of('\t'));
+    inside = inside || line == std::string(function) + ":";
+    if (inside) {
+      lines.push_back(line);
+    }
+    if (line == ".size " + std::string(function) + ", .-" + std::string(function)) {
+      break;
+    }
+  }
+  return lines;
+}
+
+// Position of the first line at or after from that starts with prefix, or
+// lines.size() if there is none.
+static std::size_t
+Find(const std::vector<std::string>& lines, std::string_view prefix, std::size_t from = 0) {
+  for (std::size_t i = from; i < lines.size(); ++i) {
+    if (lines[i].starts_with(prefix)) {
+      return i;
+    }
+  }
+  return lines.size();
+}
+
+static const std::string_view Sum = "sum :: (a: int, b: int, c: int, d: int, e: int, f: int, g: int, h: int) int {\n"
+                                    "  return a + b + c + d + e + f + g * 2 + h * 3;\n"
+                                    "}\n";
+
+TEST(X86GeneratorTest, PushesArgumentsPastTheSixth) {
+  const std::string source = std::string(Sum) + "main :: () int {\n  return sum(1, 2, 3, 4, 5, 6, 7, 8);\n}\n";
+  const std::vector<std::string> main = Function(source, "main");
+  const std::size_t call = Find(main, "call sum");
+  ASSERT_LT(call, main.size());
+  // Last first, so the seventh ends up lowest; two of them keep the stack
+  // 16-byte aligned without padding.
+  const std::size_t eighth = Find(main, "pushq $");
+  ASSERT_LT(eighth + 1, call);
+  EXPECT_EQ(main[eighth], "pushq $8");
+  EXPECT_EQ(main[eighth + 1], "pushq $7");
+  EXPECT_EQ(Find(main, "pushq $", eighth + 2), main.size());
+  EXPECT_EQ(Find(main, "subq $8, %rsp"), main.size());
+  EXPECT_EQ(main[call + 1], "addq $16, %rsp");
+
+  const std::vector<std::string> sum = Function(source, "sum");
+  EXPECT_LT(Find(sum, "movq 16(%rbp), "), sum.size());
+  EXPECT_LT(Find(sum, "movq 24(%rbp), "), sum.size());
+}
+
+TEST(X86GeneratorTest, PadsAnOddNumberOfStackArguments) {
+  const std::string source = "seven :: (a: int, b: int, c: int, d: int, e: int, f: int, g: int) int {\n"
+                             "  return a + g;\n"
+                             "}\n"
+                             "main :: () int {\n  return seven(1, 2, 3, 4, 5, 6, 7);\n}\n";
+  const std::vector<std::string> main = Function(source, "main");
+  const std::size_t padding = Find(main, "subq $8, %rsp");
+  ASSERT_LT(padding + 1, main.size());
+  EXPECT_EQ(main[padding + 1], "pushq $7");
+  const std::size_t call = Find(main, "call seven", padding);
+  ASSERT_LT(call + 1, main.size());
+  EXPECT_EQ(main[call + 1], "addq $16, %rsp");
+}
+
+TEST(X86GeneratorTest, SavesAndRestoresCalleeSavedRegisters) {
+  // a and b are needed after the second call, so they live in registers
+  // the callee preserves.
+  const std::string source = std::string(Sum) +
+                             "keep :: (a: int) int {\n"
+                             "  b:int = sum(a, 2, 3, 4, 5, 6, 7, 8);\n"
+                             "  c:int = sum(b, a, 3, 4, 5, 6, 7, 8);\n"
+                             "  return a + b + c;\n"
+                             "}\n"
+                             "main :: () int {\n  return keep(1);\n}\n";
+  const std::vector<std::string> keep = Function(source, "keep");
+  const std::size_t frame = Find(keep, "subq $16, %rsp");
+  const std::size_t leave = Find(keep, "leave");
+  ASSERT_LT(frame + 2, leave);
+  ASSERT_LT(leave, keep.size());
+  EXPECT_EQ(keep[frame + 1], "movq %rbx, -8(%rbp)");
+  EXPECT_EQ(keep[frame + 2], "movq %r12, -16(%rbp)");
+  EXPECT_EQ(keep[leave - 2], "movq -8(%rbp), %rbx");
+  EXPECT_EQ(keep[leave - 1], "movq -16(%rbp), %r12");
+  EXPECT_EQ(keep[leave + 1], "ret");
+
+  // A function whose values all die at its calls saves nothing.
+  const std::vector<std::string> main = Function(source, "main");
+  EXPECT_EQ(Find(main, "movq %rbx"), main.size());
+  EXPECT_EQ(Find(main, "movq %r12"), main.size());
+}
+
+TEST(X86GeneratorTest, DividesByAConstantWithAMultiply) {
+  const std::string source = "divide :: (a: int) int {\n  return a / 7;\n}\nmain :: () int {\n  return divide(100);\n}\n";
+  const std::vector<std::string> divide = Function(source, "divide");
+  // The quotient is the high half of a times ceil(2^65 / 7), shifted right
+  // once more, plus one when it is negative.
+  const std::size_t magic = Find(divide, "movabsq $5270498306774157605, %rax");
+  const std::size_t multiply = Find(divide, "imulq %", magic);
+  const std::size_t shift = Find(divide, "sarq $1, ", multiply);
+  const std::size_t sign = Find(divide, "shrq $63, ", shift);
+  const std::size_t add = Find(divide, "addq ", sign);
+  EXPECT_LT(magic, multiply);
+  EXPECT_LT(add, divide.size());
+  EXPECT_EQ(Find(divide, "idivq"), divide.size());
+  EXPECT_EQ(Find(divide, "cqto"), divide.size());
+}
+
+TEST(X86GeneratorTest, SubtractsTheSmallestConstantThroughARegister) {
+  // p stays live, so the difference goes to another register, where lea
+  // could subtract a constant whose negation fits 32 bits; -2^63 has none.
+  const std::string source = "f :: (p: int) int {\n  r:int = p - (1073741824 * 1073741824 * 8);\n  return r + p * 3;\n}\n"
+                             "main :: () int {\n  return f(5);\n}\n";
+  const std::vector<std::string> f = Function(source, "f");
+  const std::size_t constant = Find(f, "movabsq $-9223372036854775808, %r11");
+  ASSERT_LT(constant + 1, f.size());
+  EXPECT_TRUE(f[constant + 1].starts_with("subq %r11, ")) << f[constant + 1];
+}
+
+TEST(X86GeneratorTest, StartsAtMainAndExitsWithItsResult) {
+  const std::string source = "one :: () int {\n  return 1;\n}\nmain :: () int {\n  return one();\n}\n";
+  CompilerOptions options;
+  options.Parse("--target=x86_64");
+  options.Parse("-O1");
+  Lexer lexer(source, "test");
+  Parser parser(lexer);
+  const std::string assembly = Generator::GenerateAssembly(*parser.parseUnit(), options);
+  EXPECT_NE(assembly.find("\t.globl _start\n_start:\n\tcall main\n\t.globl main\n"), std::string::npos);
+  EXPECT_EQ(assembly.find("_start:"), assembly.rfind("_start:"));
+
+  // main's return value is the exit status of the exit system call.
+  const std::vector<std::string> main = Function(source, "main");
+  const std::size_t leave = Find(main, "leave");
+  ASSERT_LT(leave + 3, main.size());
+  EXPECT_EQ(main[leave + 1], "movq %rax, %rdi");
+  EXPECT_EQ(main[leave + 2], "movl $60, %eax");
+  EXPECT_EQ(main[leave + 3], "syscall");
+  EXPECT_EQ(Find(main, "ret"), main.size());
+
+  // Other functions return normally, and a unit without main has no entry.
+  const std::vector<std::string> one = Function(source, "one");
+  EXPECT_LT(Find(one, "ret"), one.size());
+  EXPECT_EQ(Find(one, "syscall"), one.size());
+  Lexer library("one :: () int {\n  return 1;\n}\n", "test");
+  Parser libraryParser(library);
+  EXPECT_EQ(Generator::GenerateAssembly(*libraryParser.parseUnit(), options).find("_start"), std::string::npos);
+}
@@ -7,25 +7,49 @@
 
 
 int main(int argc, char *argv[]) {
-  if (1 == argc && **argv == '/') {
+  // Options may appear anywhere; what remains is the command.
+  CompilerOptions options;
+  std::vector<std::string_view> args;
+  for (int i = 0; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    try {
+      if (!options.Parse(arg)) {
+        args.push_back(arg);
+      }
+    } catch (const std::runtime_error& error) {
+      std::cerr << "Error: " << error.what() << std::endl;
+      return 1;
+    }
+  }
+
+  if (1 == args.size() && args[0].front() == '/') {
     Lexer lexer("../example.cej");
     Parser parser(lexer);
     auto tree = parser.parseUnit();
-    std::string outData = Generator::GenerateAssembly(tree);
+    if (options.reportArena) {
+      parser.reportArena(*tree, std::cout);
+    }
+    IRModule module = Generator::BuildIR(*tree, options);
+    std::string outData = Generator::GenerateAssembly(module, options);
 
     std::ofstream outFile("output.s");
     outFile.write(outData.data(), outData.size());
     outFile.close();
+    if (options.emitIR) {
+      std::ofstream irFile("output.ir");
+      irFile << IRPrinter::Print(module);
+    }
 
     return 0;
   }
-  if (2 == argc) {
-    std::cerr << "Usage: CejCompiler -b \"buildFilePath\"";
+  if (2 == args.size()) {
+    std::cerr << "Usage: CejCompiler [--target=aarch64|x86_64] [-O0|-O1|-O2|-Os] [-f<pass>|-fno-<pass>] [-finline-limit=N] [--print-passes] [--emit-asm] [--emit-ir] [--report-arena] [--report-spills] [--report-dead-code] [--report-folded-calls] [--report-peephole] -b \"buildFilePath\"";
     return 1;
   }
-  if (3 == argc && std::string_view(argv[1]) == "-b") {
+  if (3 == args.size() && args[1] == "-b") {
     BuildSystem buildSystem;
-    buildSystem.ParseBuildFile(std::string(argv[2]));
+    buildSystem.options = options;
+    buildSystem.ParseBuildFile(std::string(args[2]));
     buildSystem.BuildAll();
     buildSystem.GenerateMakefile("Makefile");
     return 0;